@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Heap allocation accounting. Configure with -DADVENT_TRACK_ALLOCATIONS=ON to replace the global
+// operator new and delete with versions that count what every thread in the process allocates while tracking.
+// Without that option the functions here still exist but nothing is counted.
+namespace advent
+{
+	struct allocation_stats
+	{
+		uint64_t num_allocations = 0;
+		uint64_t bytes_allocated = 0;
+		uint64_t peak_live_bytes = 0;
+	};
+
+	std::string to_human_readable(const allocation_stats& stats);
+
+	// E.g. "1.5MB".
+	std::string bytes_to_human_readable(uint64_t bytes);
+
+	// True if this build replaces operator new/delete.
+	bool allocation_tracking_enabled() noexcept;
+
+	// Start counting allocations made by any thread, including ones the calling thread goes on to start.
+	// Peak live bytes are measured from this point, and never go below zero even if memory from before is freed.
+	// If other threads are tracking at the same time, their allocations are counted too.
+	void start_allocation_tracking() noexcept;
+
+	// Get what was allocated since the calling thread's start_allocation_tracking(), and stop tracking
+	// once no other thread is. Returns nothing counted if this thread wasn't tracking.
+	allocation_stats stop_allocation_tracking() noexcept;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <chrono>
+#include <span>
+#include <filesystem>
+
+// Batch mode runs a day's solutions on many input files instead of adventX/adventX.txt. Used by --batch.
+// Each file is loaded into memory first, then open_puzzle_input reads it in place of the usual file.
+namespace advent
+{
+	// The files a --batch path names: every regular file in a directory, the files matching a pattern
+	// with * or ? in its last part (e.g. "corpus/day5/*.txt"), or else the file itself. Sorted by name.
+	// Empty if nothing matches.
+	std::vector<std::filesystem::path> expand_batch_path(const std::string& path);
+
+	// * matches any run of characters and ? matches any single character.
+	bool wildcard_match(std::string_view pattern, std::string_view text) noexcept;
+
+	struct batch_test_result
+	{
+		std::string_view test_name;
+		std::string result;
+		std::chrono::nanoseconds time{ 0 };
+		bool error = false;	// The solution failed a check. result holds the message.
+	};
+
+	// What the day's solutions gave for one input file.
+	struct batch_file_result
+	{
+		int day = 0;
+		std::string filename;
+		std::size_t bytes = 0;
+		std::chrono::nanoseconds load_time{ 0 };
+		std::chrono::nanoseconds parse_time{ 0 };	// Parsing shared by the solutions of a PARSED_DAY.
+		std::vector<batch_test_result> tests;
+		bool read_error = false;
+	};
+
+	struct batch_summary
+	{
+		std::size_t num_files = 0;
+		std::size_t num_errors = 0;
+		std::size_t total_bytes = 0;
+		std::chrono::nanoseconds solve_time{ 0 };	// Summed over every solution on every file, including shared parsing.
+		std::chrono::nanoseconds wall_time{ 0 };
+
+		double files_per_second() const noexcept;
+		double megabytes_per_second() const noexcept;
+	};
+
+	batch_summary summarise_batch(std::span<const batch_file_result> results, std::chrono::nanoseconds wall_time);
+
+	// One line: the file, then each solution's result and time.
+	std::string to_human_readable(const batch_file_result& result);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// CPU time alongside wall time, so a solution that uses several cores (e.g. through std::execution
+// policies) shows how much work it really did. Used by --cpu.
+// Collected with clock_gettime and getrusage on Linux. Elsewhere is_cpu_usage_available() is false.
+namespace advent
+{
+	struct cpu_usage
+	{
+		std::chrono::nanoseconds wall{ 0 };
+		std::chrono::nanoseconds thread_cpu{ 0 };	// The thread running the test.
+		std::chrono::nanoseconds process_user{ 0 };	// Every thread in the process, including any the test starts.
+		std::chrono::nanoseconds process_system{ 0 };
+
+		// Of the whole process.
+		uint64_t voluntary_switches = 0;	// Gave up the CPU, e.g. to wait for a lock or for I/O.
+		uint64_t involuntary_switches = 0;	// Preempted by the scheduler.
+		uint64_t minor_faults = 0;
+		uint64_t major_faults = 0;	// Had to read from disk.
+
+		std::chrono::nanoseconds process_cpu() const noexcept { return process_user + process_system; }
+
+		// How many cores were busy on average: process CPU time over wall time.
+		double parallelism() const noexcept;
+
+		cpu_usage& operator+=(const cpu_usage& other) noexcept;
+		cpu_usage& operator/=(uint64_t divisor) noexcept;
+	};
+
+	std::string to_human_readable(const cpu_usage& usage);
+
+	bool is_cpu_usage_available() noexcept;
+
+	// Measures the CPU usage of a stretch of code.
+	class cpu_usage_meter
+	{
+		cpu_usage m_start;
+		std::chrono::high_resolution_clock::time_point m_start_time;
+	public:
+		void start() noexcept;
+
+		// What was used since start().
+		cpu_usage stop() const noexcept;
+	};
+}
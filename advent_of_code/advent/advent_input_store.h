@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+// Input files held in memory so they can be read without touching the filesystem.
+// The runner loads each test's puzzle input here before starting the clock, and
+// advent::open_input reads from here when the file has been loaded.
+namespace advent::input_store
+{
+	// Reads the whole file into the store if it isn't there already.
+	// Returns false if the file couldn't be read.
+	bool preload(const std::string& filename);
+
+	// Returns nullptr if the file hasn't been loaded.
+	std::shared_ptr<const std::string> find(const std::string& filename);
+
+	// Drops everything that has been loaded.
+	void clear();
+
+	// Makes advent::open_puzzle_input on the calling thread read this data, whatever the day,
+	// until it is set back to nullptr. Batch mode uses this to feed the solutions other inputs.
+	void set_puzzle_input_override(std::shared_ptr<const std::string> data);
+	std::shared_ptr<const std::string> get_puzzle_input_override();
+}
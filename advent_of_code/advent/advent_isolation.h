@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "advent_test_result.h"
+
+namespace advent
+{
+	// True if tests can be run in a child process on this platform (anything with posix_spawn).
+	bool process_isolation_supported() noexcept;
+
+	// Runs a test in a new copy of this program, started with child_args (argv[0] first), and passes its result back.
+	// The child must send its result with report_to_isolating_parent. Starting a fresh process rather than forking
+	// means the child can't inherit a lock held by another of the parent's threads, e.g. with --jobs.
+	// If the child crashes, exits without reporting a result, or takes longer than timeout (which must be
+	// non-zero), the result has status crashed, exited or timed_out instead. The output it reports is copied to out.
+	test_result run_isolated(
+		const std::vector<std::string>& child_args,
+		std::string_view name,
+		const std::string& expected,
+		std::chrono::milliseconds timeout,
+		std::ostream& out);
+
+	// In the child started by run_isolated: sends the test's result and console output to the parent.
+	void report_to_isolating_parent(const test_result& result, const std::string& output);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <variant>
+#include <optional>
+#include <utility>
+#include <cstdint>
+#include <concepts>
+
+// A small JSON document model used by the runner for reports, caches and history files.
+// Objects keep their keys in insertion order so written files are stable and diffable.
+namespace advent::json
+{
+	class value;
+	using array = std::vector<value>;
+	using object = std::vector<std::pair<std::string, value>>;
+
+	class value
+	{
+		std::variant<std::nullptr_t, bool, double, std::string, array, object> m_data;
+	public:
+		value() noexcept : m_data{ nullptr } {}
+		value(std::nullptr_t) noexcept : m_data{ nullptr } {}
+		value(bool b) noexcept : m_data{ b } {}
+		value(double d) noexcept : m_data{ d } {}
+		template <std::integral T> requires (!std::same_as<T, bool>)
+		value(T i) noexcept : m_data{ static_cast<double>(i) } {}
+		value(std::string s) noexcept : m_data{ std::move(s) } {}
+		value(std::string_view s) : m_data{ std::string{ s } } {}
+		value(const char* s) : m_data{ std::string{ s } } {}
+		value(array a) noexcept : m_data{ std::move(a) } {}
+		value(object o) noexcept : m_data{ std::move(o) } {}
+
+		bool is_null() const noexcept { return std::holds_alternative<std::nullptr_t>(m_data); }
+		bool is_bool() const noexcept { return std::holds_alternative<bool>(m_data); }
+		bool is_number() const noexcept { return std::holds_alternative<double>(m_data); }
+		bool is_string() const noexcept { return std::holds_alternative<std::string>(m_data); }
+		bool is_array() const noexcept { return std::holds_alternative<array>(m_data); }
+		bool is_object() const noexcept { return std::holds_alternative<object>(m_data); }
+
+		// These check the type, so only call them after checking with is_xxx or when the type is known.
+		bool as_bool() const;
+		double as_number() const;
+		int64_t as_int() const;
+		const std::string& as_string() const;
+		const array& as_array() const;
+		array& as_array();
+		const object& as_object() const;
+		object& as_object();
+
+		// Object helpers. find returns nullptr if this is not an object or the key is missing.
+		const value* find(std::string_view key) const noexcept;
+		void set(std::string_view key, value v);
+
+		// Typed lookups with a fallback for when the key is missing or has the wrong type.
+		double get_number(std::string_view key, double fallback = 0.0) const noexcept;
+		int64_t get_int(std::string_view key, int64_t fallback = 0) const noexcept;
+		std::string get_string(std::string_view key, std::string_view fallback = "") const;
+	};
+
+	// Writes the value as JSON. With a non-zero indent, nested values go on their own lines.
+	std::string to_string(const value& v, int indent = 0);
+
+	// Returns std::nullopt if the text is not valid JSON.
+	std::optional<value> parse(std::string_view text);
+
+	// Reads and parses a whole file. Returns std::nullopt if it can't be opened or parsed.
+	std::optional<value> read_file(const std::string& filename);
+
+	// Returns false if the file could not be written.
+	bool write_file(const std::string& filename, const value& v);
+}
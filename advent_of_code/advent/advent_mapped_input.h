@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Read-only access to a whole input file as one block of memory, without copying it through a stream.
+// Parse straight from view(), e.g. with utils::split_string, instead of reading lines into std::strings.
+namespace advent
+{
+	// Owns the memory behind view(): a read-only mmap of the file, a buffer it was read into
+	// (for pipes and anything else that can't be mapped), or data already in the input store.
+	// view() is valid for as long as the handle lives. Move-only.
+	class mapped_input
+	{
+		std::string_view m_view;
+		void* m_mapping = nullptr;
+		std::size_t m_mapping_size = 0;
+		std::shared_ptr<const std::string> m_buffer;
+	public:
+		mapped_input() noexcept = default;
+		explicit mapped_input(std::shared_ptr<const std::string> data) noexcept;
+		mapped_input(void* mapping, std::size_t size) noexcept;
+		~mapped_input();
+
+		mapped_input(mapped_input&& other) noexcept;
+		mapped_input& operator=(mapped_input&& other) noexcept;
+		mapped_input(const mapped_input&) = delete;
+		mapped_input& operator=(const mapped_input&) = delete;
+
+		std::string_view view() const noexcept { return m_view; }
+		const char* data() const noexcept { return m_view.data(); }
+		std::size_t size() const noexcept { return m_view.size(); }
+		bool empty() const noexcept { return m_view.empty(); }
+
+		// True if view() is an mmap of the file rather than a copy of it.
+		bool is_mapped() const noexcept { return m_mapping != nullptr; }
+	};
+
+	// Maps the file read-only and hints the kernel that it will be read from start to end.
+	// Falls back to reading the file into a buffer when it can't be mapped, e.g. a pipe or an empty file.
+	// If the file is already in the input store, views that instead. Fails an AdventCheck if it can't be opened.
+	mapped_input map_input(const std::string& filename);
+
+	// The input open_puzzle_input would read: "adventX/adventX.txt", or in batch mode the file being run.
+	mapped_input map_puzzle_input(int day);
+}
@@ -2,5 +2,97 @@
 
 #include <string_view>
 #include <vector>
+#include <chrono>
+#include <string>
+#include <optional>
 
-bool verify_all(const std::vector<std::string_view>& filters);
\ No newline at end of file
+// Controls how verify_all runs the tests. Built from the command line by parse_run_options.
+struct run_options
+{
+	// Only run tests whose name contains one of these. Leave empty to run everything.
+	std::vector<std::string_view> filters;
+
+	// How many tests to run at once. 1 runs everything on the calling thread.
+	std::size_t num_jobs = 1;
+
+	// Record how long each test takes in this file, and with num_jobs > 1 start the longest tests first.
+	std::string history_file;
+
+	// Benchmark mode. Each test is run warmup_runs times untimed, then timed at least repetitions times.
+	// If time_budget is set, the first timed run is used to pick a repetition count that fills it.
+	std::size_t warmup_runs = 0;
+	std::size_t repetitions = 1;
+	std::chrono::milliseconds time_budget{ 0 };
+
+	// Keep timings steady. pin_cpu pins the thread running the tests to that CPU (with num_jobs > 1, worker i
+	// gets pin_cpu + i). high_priority lowers the nice value of those threads as far as allowed.
+	// Tests whose repeated runs vary by more than noise_threshold of their mean are flagged as noisy.
+	std::optional<int> pin_cpu;
+	bool high_priority = false;
+	double noise_threshold = 0.05;
+
+	// Collect hardware performance counters (cycles, instructions, cache and branch misses) for each test.
+	bool perf_counters = false;
+
+	// Measure thread and process CPU time, context switches and page faults of each test alongside its wall time.
+	bool measure_cpu = false;
+
+	// Record the call tree of advent::profile_scope markers hit by each test.
+	bool profile = false;
+
+	// Run each test in its own child process so a crash or hang can't take down the rest.
+	// A test that runs longer than timeout is killed, or after 10 minutes if it's zero. Setting a timeout turns on isolation.
+	bool isolate = false;
+	std::chrono::milliseconds timeout{ 0 };
+
+	// Set in the child process of an isolated test: run only the test with this name and report it to the parent.
+	std::string isolated_child_test;
+
+	// Reuse results stored in this file for tests whose code and input haven't changed, and store new ones.
+	// force runs every test anyway (and still updates the cache). program_path is argv[0], used to hash the
+	// binary when /proc/self/exe isn't available.
+	std::string cache_file;
+	bool force = false;
+	std::string program_path;
+
+	// The command line after argv[0], passed on to the child process of each isolated test.
+	std::vector<std::string> args;
+
+	// Sample the stack of each test sample_frequency times per second of CPU, and write the stacks to
+	// "<sample_dir>/<test name>.folded" for flame graph tools.
+	std::string sample_dir;
+	int sample_frequency = 997;
+
+	// Instead of the tests, run each scaling test in scaling_tests[] on inputs of these multiples of the normal size,
+	// and fit how its time and memory grow. Scales predicted to take longer than scaling_time_limit are skipped.
+	bool scaling = false;
+	std::vector<std::size_t> scales{ 1, 10, 100, 1000 };
+	std::chrono::milliseconds scaling_time_limit{ 10'000 };
+
+	// Instead of the tests, run each day's solutions on every file a path names (a directory, a file, or a
+	// pattern like "dir/*.txt") in place of its puzzle input. Files are spread over num_jobs threads.
+	struct batch_source
+	{
+		int day = 0;
+		std::string path;
+	};
+	std::vector<batch_source> batch_sources;
+
+	// Write a Chrome trace event timeline of the run to this file, for Perfetto or chrome://tracing.
+	std::string trace_file;
+
+	// Write the results to this file. Ending the name with ".csv" gives CSV, otherwise it's JSON.
+	std::string report_file;
+
+	// Compare timings against this JSON report and fail if any test got slower by more than regression_threshold.
+	std::string baseline_file;
+	double regression_threshold = 0.1;
+};
+
+// Anything starting with "--" is an option, and anything else is a filter.
+// Prints a message and exits if an option is not recognised.
+run_options parse_run_options(int argc, char** argv);
+
+// Returns false if any test failed or, with a baseline, regressed.
+bool verify_all(const std::vector<std::string_view>& filters);
+bool verify_all(const run_options& options);
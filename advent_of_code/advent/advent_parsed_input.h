@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <istream>
+
+#include "advent_types.h"
+#include "advent_utils.h"
+
+// Lets a day parse its puzzle input once and share the result between part 1 and part 2.
+//
+//     struct parsed_input { std::vector<int> numbers; };
+//     parsed_input parse(std::istream& input);
+//
+//     ParseTiming advent_one_parse() { return advent::parse_puzzle_input(1, parse); }
+//     ResultType advent_one_p1() { return solve_p1(advent::get_parsed_puzzle_input(1, parse)); }
+//     ResultType advent_one_p2() { return solve_p2(advent::get_parsed_puzzle_input(1, parse)); }
+//
+// Register the day with PARSED_DAY in advent_setup.h and the runner calls advent_one_parse before
+// starting each part's clock, reporting the parse time separately. Whichever part comes first does the
+// parsing. If both parts run at once (with --jobs), the second waits for the first to finish parsing.
+// A parse is reused only for the same input data, so batch mode still parses each file.
+namespace advent
+{
+	namespace parsed_input_cache
+	{
+		// Parse functions are told apart by address, stored as this type.
+		using parse_id = void(*)();
+
+		// Parses input into a new object owned by the returned pointer.
+		using parse_thunk = std::shared_ptr<const void>(*)(std::istream& input, parse_id parse);
+
+		struct entry_view
+		{
+			std::shared_ptr<const void> parsed;
+			ParseTiming timing;
+		};
+
+		// Returns the result of parse on data, running it only if it hasn't already been run on that data.
+		// Kept until data is released. If parsing throws, nothing is kept and the next call tries again.
+		entry_view get(parse_id parse, const std::shared_ptr<const std::string>& data, parse_thunk thunk);
+
+		// Drops everything that has been parsed.
+		void clear();
+
+		template <typename Parsed>
+		std::shared_ptr<const void> parse_into(std::istream& input, parse_id parse)
+		{
+			return std::make_shared<const Parsed>(reinterpret_cast<Parsed(*)(std::istream&)>(parse)(input));
+		}
+
+		template <typename Parsed>
+		entry_view get_for_day(int day, Parsed(*parse)(std::istream&))
+		{
+			return get(reinterpret_cast<parse_id>(parse), load_puzzle_input(day), &parse_into<Parsed>);
+		}
+	}
+
+	// The day's puzzle input as parse returns it, parsing it on the first call.
+	template <typename Parsed>
+	const Parsed& get_parsed_puzzle_input(int day, Parsed(*parse)(std::istream&))
+	{
+		return *static_cast<const Parsed*>(parsed_input_cache::get_for_day(day, parse).parsed.get());
+	}
+
+	// Makes sure the day's puzzle input has been parsed and says how long it took.
+	template <typename Parsed>
+	ParseTiming parse_puzzle_input(int day, Parsed(*parse)(std::istream&))
+	{
+		return parsed_input_cache::get_for_day(day, parse).timing;
+	}
+}
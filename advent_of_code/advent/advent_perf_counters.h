@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <cstdint>
+#include <string>
+
+namespace advent
+{
+	// Counts from the hardware performance counters. A counter is empty if it couldn't be collected.
+	struct perf_counter_values
+	{
+		std::optional<uint64_t> cycles;
+		std::optional<uint64_t> instructions;
+		std::optional<uint64_t> l1d_read_misses;
+		std::optional<uint64_t> llc_misses;
+		std::optional<uint64_t> branch_misses;
+
+		bool empty() const noexcept { return !(cycles || instructions || l1d_read_misses || llc_misses || branch_misses); }
+		std::optional<double> instructions_per_cycle() const noexcept;
+
+		perf_counter_values& operator+=(const perf_counter_values& other) noexcept;
+		perf_counter_values& operator/=(uint64_t divisor) noexcept;
+	};
+
+	std::string to_human_readable(const perf_counter_values& values);
+
+	// Hardware performance counters for the calling thread. Uses perf_event_open on Linux.
+	// On other platforms, or if the kernel refuses (see /proc/sys/kernel/perf_event_paranoid),
+	// is_available() is false and stop() returns empty values.
+	class perf_counters
+	{
+		static constexpr std::size_t NUM_COUNTERS = 5;
+		std::array<int, NUM_COUNTERS> m_fds;
+	public:
+		perf_counters();
+		~perf_counters();
+		perf_counters(const perf_counters&) = delete;
+		perf_counters& operator=(const perf_counters&) = delete;
+
+		bool is_available() const noexcept;
+
+		// Resets the counters and starts counting.
+		void start() noexcept;
+
+		// Stops counting and returns the counts since start(), scaled up if the kernel had to multiplex counters.
+		perf_counter_values stop() noexcept;
+	};
+}
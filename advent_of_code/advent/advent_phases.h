@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+
+// Lets a solution split its running time into named phases, e.g. "parse" and "solve":
+//
+//     advent::begin_phase("parse");
+//     const auto grid = parse_grid(input);
+//     advent::begin_phase("solve");
+//     return find_path(grid);
+//
+// Each call ends the previous phase. The last phase ends when the test function returns.
+// Time spent before the first call is reported as "unphased".
+namespace advent
+{
+	// Does nothing unless the runner is recording phases on this thread.
+	// The name must outlive the test, so use string literals.
+	void begin_phase(std::string_view name) noexcept;
+
+	struct phase_timing
+	{
+		std::string name;
+		std::chrono::nanoseconds time{ 0 };
+	};
+
+	// Records the phases of whatever runs on the calling thread between start() and stop().
+	// Phases with the same name are added together, including across multiple start/stop pairs.
+	class phase_recorder
+	{
+		struct raw_phase
+		{
+			std::string_view name;
+			std::chrono::nanoseconds time;
+		};
+		std::vector<raw_phase> m_phases;
+		std::string_view m_current_phase;
+		std::chrono::high_resolution_clock::time_point m_phase_start;
+		bool m_any_phases = false;
+		void add_time(std::string_view name, std::chrono::nanoseconds time);
+		friend void begin_phase(std::string_view) noexcept;
+	public:
+		void start() noexcept;
+		void stop() noexcept;
+
+		// Empty unless the solution called begin_phase.
+		std::vector<phase_timing> get_phases() const;
+	};
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+// Lets solution and utils code time the pieces of a test that matter:
+//
+//     void state::tick()
+//     {
+//         AdventProfileScope("conway::tick");
+//         ...
+//     }
+//
+// With --profile, every scope entered while a test runs is gathered into a call tree with call counts and
+// inclusive and exclusive time, and printed after the test. Scopes with the same name under the same parent
+// are added together. With --trace, each scope also shows up on the timeline.
+// Without either, a scope costs a thread-local read and a branch.
+// Only scopes on the thread running the test are recorded.
+namespace advent
+{
+	struct profile_node
+	{
+		std::string name;
+		uint64_t calls = 0;
+		std::chrono::nanoseconds inclusive_time{ 0 };
+		std::chrono::nanoseconds exclusive_time{ 0 };
+		std::vector<profile_node> children;
+	};
+
+	// Records the scopes entered on the calling thread between start() and stop().
+	class profile_recorder
+	{
+		struct node
+		{
+			std::string_view name;
+			std::size_t parent = 0;
+			std::size_t first_child = 0;	// 0 means no children, since the root is never anybody's child.
+			std::size_t next_sibling = 0;
+			uint64_t calls = 0;
+			std::chrono::nanoseconds inclusive_time{ 0 };
+		};
+		std::vector<node> m_nodes;
+		std::size_t m_current = 0;
+		std::size_t m_num_runs = 0;
+
+		profile_node make_tree(std::size_t node_idx) const;
+	public:
+		profile_recorder();
+
+		void start() noexcept;
+		void stop() noexcept;
+
+		// Called by profile_scope. Returns the node to pass to exit.
+		std::size_t enter(std::string_view name);
+		void exit(std::size_t node_idx, std::chrono::high_resolution_clock::time_point start, std::chrono::high_resolution_clock::time_point end) noexcept;
+
+		// The top level scopes. Counts and times are averaged over the start/stop pairs.
+		std::vector<profile_node> get_tree() const;
+	};
+
+	namespace internal_helpers
+	{
+		// Set by profile_recorder::start. Read inline so that a disabled scope is as cheap as possible.
+		extern thread_local profile_recorder* active_profile_recorder;
+	}
+
+	class profile_scope
+	{
+		profile_recorder* m_recorder;
+		std::size_t m_node = 0;
+		std::chrono::high_resolution_clock::time_point m_start;
+	public:
+		// The name must outlive the test, so use string literals.
+		explicit profile_scope(std::string_view name) noexcept
+			: m_recorder{ internal_helpers::active_profile_recorder }
+		{
+			if (m_recorder != nullptr)
+			{
+				m_node = m_recorder->enter(name);
+				m_start = std::chrono::high_resolution_clock::now();
+			}
+		}
+
+		~profile_scope()
+		{
+			if (m_recorder != nullptr)
+			{
+				m_recorder->exit(m_node, m_start, std::chrono::high_resolution_clock::now());
+			}
+		}
+
+		profile_scope(const profile_scope&) = delete;
+		profile_scope& operator=(const profile_scope&) = delete;
+	};
+
+	// One line per scope, indented to show the tree.
+	std::string to_human_readable(const std::vector<profile_node>& tree);
+}
+
+#define ADVENT_PROFILE_CONCAT_IMPL(a,b) a ## b
+#define ADVENT_PROFILE_CONCAT(a,b) ADVENT_PROFILE_CONCAT_IMPL(a,b)
+#define AdventProfileScope(name) const advent::profile_scope ADVENT_PROFILE_CONCAT(advent_profile_scope_,__LINE__){ name }
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <optional>
+#include <iosfwd>
+
+#include "advent_test_result.h"
+#include "advent_batch.h"
+#include "advent_json.h"
+
+struct run_options;
+
+namespace advent
+{
+	// Describes the build and the run that produced a set of results: git commit, compiler, flags and options.
+	json::value get_run_metadata(const run_options& options);
+
+	json::value to_json(const test_result& result);
+	std::optional<test_result> test_result_from_json(const json::value& v);
+
+	// Writes the results as CSV if the filename ends in ".csv", and as JSON otherwise.
+	// Returns false if the file could not be written.
+	bool write_report(const std::string& filename, std::span<const test_result> results, const run_options& options);
+
+	// Writes the results of --batch, one row per solution per file. CSV or JSON as for write_report.
+	bool write_batch_report(const std::string& filename, std::span<const batch_file_result> results, const batch_summary& summary, const run_options& options);
+
+	// Compares each test's time against a JSON report from a previous run. Prints the tests that changed by
+	// more than threshold (e.g. 0.1 for 10%) and returns false if any got slower by more than that.
+	bool check_against_baseline(const std::string& filename, std::span<const test_result> results, double threshold, std::ostream& out);
+}
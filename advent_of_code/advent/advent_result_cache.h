@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <filesystem>
+
+#include "advent_test_result.h"
+#include "advent_json.h"
+
+namespace advent
+{
+	// Remembers test results between runs so tests whose code and input haven't changed don't run again.
+	// Each result is stored with a key made from the test's name and expected result, the contents of its
+	// day directory (sources and inputs), the framework's sources, every local header those include along with
+	// the .cpp that implements it, and the compiler and flags. A test that can't be traced to a day directory,
+	// or is run from somewhere the sources can't be found, is keyed on the whole binary instead.
+	// All member functions are safe to call from several threads at once.
+	class result_cache
+	{
+		std::string m_filename;
+		std::filesystem::path m_program_path;
+		json::value m_entries;
+		std::mutex m_lock;
+		std::map<int, std::optional<uint64_t>> m_day_hashes;
+		std::optional<uint64_t> m_binary_hash;
+		bool m_modified = false;
+		bool m_warned_no_sources = false;
+
+		std::optional<uint64_t> get_day_hash(int day);
+		uint64_t get_binary_hash();
+	public:
+		// Loads the cache from filename. A missing or unreadable file gives an empty cache.
+		result_cache(std::string filename, std::filesystem::path program_path);
+
+		// Returns std::nullopt if the test's result should not be cached. This happens when the day's
+		// sources are newer than the program, since the result would then belong to code that isn't built yet.
+		std::optional<uint64_t> get_key(std::string_view test_name, const std::string& expected, std::optional<int> day);
+
+		// Returns the stored result if it was stored with the same key.
+		std::optional<test_result> find(std::string_view test_name, uint64_t key);
+
+		// Only pass, fail and unknown results are stored. Crashes and timeouts are always run again.
+		void store(const test_result& result, uint64_t key);
+
+		// Writes the cache back if anything was stored. Returns false if the file could not be written.
+		bool save();
+	};
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace advent
+{
+	// A sampling profiler for the calling thread. Between start() and stop() a CPU-time timer interrupts the
+	// thread frequency_hz times per second of CPU it uses, and the stack is recorded each time. Used by --sample.
+	// Only available on Linux. Elsewhere, or if the timer can't be set up, is_available() is false and nothing is recorded.
+	class sampling_profiler
+	{
+	public:
+		struct impl;
+	private:
+		std::unique_ptr<impl> m_impl;
+	public:
+		explicit sampling_profiler(int frequency_hz);
+		~sampling_profiler();
+		sampling_profiler(const sampling_profiler&) = delete;
+		sampling_profiler& operator=(const sampling_profiler&) = delete;
+
+		bool is_available() const noexcept;
+
+		// Samples add up over several start/stop pairs.
+		void start() noexcept;
+		void stop() noexcept;
+
+		std::size_t num_samples() const noexcept;
+
+		// Samples that didn't fit in the buffer.
+		std::size_t num_dropped() const noexcept;
+
+		// One line per distinct stack: "outermost;...;innermost count", as read by flamegraph.pl, inferno and speedscope.
+		// Stacks start at the function that called start(), so the runner's own frames are left out.
+		std::string get_folded_stacks() const;
+	};
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <chrono>
+#include <span>
+#include <cstdint>
+#include <iosfwd>
+
+#include "advent_types.h"
+#include "advent_testcase_setup.h"
+
+struct run_options;
+
+// Runs a solver on inputs 1x, 10x, 100x... the normal size and fits how its time and memory grow. Used by --scale.
+// An exponent near 1 is linear and near 2 is quadratic, so an accidentally quadratic solution stands out
+// long before it meets a large input for real.
+namespace advent
+{
+	struct scaling_point
+	{
+		std::size_t scale = 0;
+		std::size_t input_bytes = 0;
+		std::chrono::nanoseconds time{ 0 };	// Median of the timed runs.
+		std::optional<uint64_t> peak_live_bytes;	// Only with allocation tracking.
+	};
+
+	struct scaling_result
+	{
+		std::string name;
+		std::vector<scaling_point> points;
+
+		// Scales not run because they were predicted to take too long.
+		std::vector<std::size_t> skipped_scales;
+
+		// How time and memory grow with the scale: time ~ scale^exponent. Needs two or more points.
+		std::optional<double> time_exponent;
+		std::optional<double> memory_exponent;
+
+		// Set if the solver threw, in which case larger scales weren't run.
+		std::optional<std::string> error;
+	};
+
+	// Least-squares slope of log(y) against log(x). Points with x or y not above zero are ignored.
+	std::optional<double> fit_growth_exponent(std::span<const std::pair<double, double>> points);
+
+	// True if time or memory looks to grow clearly faster than linearly.
+	bool has_superlinear_growth(const scaling_result& result) noexcept;
+
+	// E.g. "linear" or "quadratic".
+	std::string_view describe_growth(double exponent) noexcept;
+
+	// Runs the test at each of options.scales, largest last. Scales predicted to take longer than
+	// options.scaling_time_limit are skipped. Warmup and repetitions are as set in options.
+	scaling_result run_scaling_test(const scaling_test& test, const run_options& options);
+
+	// A table of the points followed by the fitted exponents, with a warning for anything worse than linear.
+	std::string to_human_readable(const scaling_result& result);
+}
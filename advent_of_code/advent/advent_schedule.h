@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <chrono>
+#include <span>
+#include <vector>
+#include <map>
+
+// Orders the tests run with --jobs so the slowest start first, using how long they took in earlier runs.
+// Starting a long test last leaves the other workers idle while it finishes, so longest-first keeps
+// the wall time close to that of the longest test. Used by --history.
+namespace advent
+{
+	// How long each test took on earlier runs, kept in a small JSON file.
+	// Not thread safe: record everything from one thread once the tests have finished.
+	class timing_history
+	{
+		std::string m_filename;
+		std::map<std::string, std::chrono::nanoseconds, std::less<>> m_times;
+		bool m_modified = false;
+	public:
+		// Loads the history from filename. A missing or unreadable file gives an empty history.
+		explicit timing_history(std::string filename);
+
+		std::optional<std::chrono::nanoseconds> find(std::string_view test_name) const;
+
+		// Blends time into the stored estimate, so one unusually slow or fast run doesn't swing the order.
+		void record(std::string_view test_name, std::chrono::nanoseconds time);
+
+		// Writes the history back if anything was recorded. Returns false if the file could not be written.
+		bool save() const;
+	};
+
+	struct scheduled_job
+	{
+		std::size_t index = 0;	// Into the names passed to schedule_longest_first.
+		std::chrono::nanoseconds estimate{ 0 };
+		bool from_history = false;	// Otherwise estimate is the default for tests with no history.
+	};
+
+	// Orders the jobs by their estimated time, longest first. Tests with no history are estimated at the
+	// median of those with one, so they land in the middle. Equal estimates keep their original order.
+	std::vector<scheduled_job> schedule_longest_first(std::span<const std::string_view> names, const timing_history& history);
+}
@@ -5,7 +5,7 @@
 #include "advent_headers.h"
 #include "advent_solutions.h"
 
-static const verification_test tests[] =
+static constinit const verification_test tests[] =
 {
 	DAY(one,DAY_01_1_SOLUTION,DAY_01_2_SOLUTION),
 	DAY(two,DAY_02_1_SOLUTION,DAY_02_2_SOLUTION),
@@ -34,10 +34,24 @@ static const verification_test tests[] =
 	DAY(twentyfive, DAY_25_1_SOLUTION,"MERRY CHRISTMAS!")
 };
 
+// Solvers to run with --scale, e.g. SCALING_TESTCASE(advent_one_p1_with_input,make_day_one_input).
+static constinit const auto scaling_tests = make_scaling_tests(
+);
+
+// Other implementations of a part to check against it and time, e.g. VARIANT(one,1,simd,advent_one_p1_simd).
+static constinit const auto solver_variants = make_variants(
+);
+
 #undef ARG
 #undef TESTCASE
+#undef SCALING_TESTCASE
+#undef VARIANT
 #undef FUNC_NAME
 #undef TEST_DECL
 #undef DAY
+#undef PARSE_FUNC_NAME
+#undef PARSED_TESTCASE
+#undef PARSED_TEST_DECL
+#undef PARSED_DAY
 #undef DUMMY
 #undef DUMMY_DAY
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "advent_timing_stats.h"
+
+// Keeping timings steady from run to run. Used by --pin-cpu, --high-priority and --noise-threshold.
+// Pinning and priority only do anything on Linux. Elsewhere they report that they failed.
+namespace advent
+{
+	// Restricts the calling thread to one CPU with sched_setaffinity, so the scheduler can't move it
+	// and throw away its caches mid-run. Returns false if the CPU doesn't exist or isn't allowed.
+	bool pin_thread_to_cpu(int cpu) noexcept;
+
+	// Lowers the calling thread's nice value as far as the process is allowed to (down to -20), so other
+	// processes get less of its CPU. Returns the nice value it ended up with, or nullopt if it couldn't change it.
+	std::optional<int> raise_thread_priority() noexcept;
+
+	// Anything about the machine's setup that is likely to make timings swing between runs,
+	// e.g. a cpufreq governor other than "performance" or turbo boost being on. Each entry is one sentence.
+	// Only looks at cpu if given, otherwise at every CPU.
+	std::vector<std::string> find_timing_noise_sources(std::optional<int> cpu);
+
+	// The cpufreq governor of a CPU, e.g. "performance" or "powersave". Empty if it can't be read.
+	std::string get_cpu_governor(int cpu);
+
+	// Times a fixed amount of arithmetic that doesn't touch memory. If the result changes over a run,
+	// the CPU's clock speed changed under the tests.
+	std::chrono::nanoseconds measure_cpu_speed() noexcept;
+
+	// True if repeated runs varied by more than threshold (e.g. 0.05 for 5%) relative to the mean.
+	// Needs three or more runs to say.
+	bool is_noisy(const timing_stats& timing, double threshold) noexcept;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <chrono>
+#include <vector>
+
+#include "advent_types.h"
+#include "advent_timing_stats.h"
+#include "advent_perf_counters.h"
+#include "advent_cpu_usage.h"
+#include "advent_alloc_tracker.h"
+#include "advent_phases.h"
+#include "advent_profile.h"
+
+// Result a test can give.
+enum class test_status : char
+{
+	pass,
+	fail,
+	unknown,
+	filtered,
+
+	// Only when running tests in a separate process.
+	crashed,	// Killed by a signal, e.g. a segfault or an abort.
+	timed_out,	// Took longer than the timeout and was killed.
+	exited		// The process exited without reporting a result.
+};
+
+std::string_view to_string(test_status status) noexcept;
+std::string to_human_readable(std::chrono::nanoseconds time);
+std::optional<test_status> test_status_from_string(std::string_view str) noexcept;
+
+// Full results of a test.
+struct test_result
+{
+	std::string name;
+	std::string result;
+	std::string expected;
+	test_status status = test_status::unknown;
+	std::chrono::nanoseconds time_taken{ 0 };
+	advent::timing_stats timing;
+	advent::perf_counter_values counters;
+	std::optional<advent::allocation_stats> allocations;
+
+	// Averaged over the timed runs. Empty unless running with --cpu.
+	std::optional<advent::cpu_usage> cpu;
+
+	// Reading the puzzle input into memory. This happens before the clock starts.
+	std::chrono::nanoseconds input_load_time{ 0 };
+
+	// Parsing the puzzle input, for the parts of a PARSED_DAY. This also happens before the clock starts.
+	std::optional<ParseTiming> input_parse;
+
+	// Empty unless the solution marks its phases with advent::begin_phase.
+	std::vector<advent::phase_timing> phases;
+
+	// The top level advent::profile_scope calls. Empty unless running with --profile.
+	std::vector<advent::profile_node> profile;
+
+	// Reported from the result cache instead of being run.
+	bool from_cache = false;
+};
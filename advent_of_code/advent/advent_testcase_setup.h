@@ -1,65 +1,143 @@
 #pragma once
 
-#include <functional>
 #include <string>
 #include <string_view>
-#include <optional>
 #include <variant>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <iosfwd>
 
-using TestFunc = std::function<ResultType()>;
-using TestFuncWithArg = std::function<ResultType(std::istream&)>;
+// Everything here is a literal type, so tests[] in advent_setup.h is built at compile time.
+// Nothing runs (or allocates) before main to set up the tests, and calling a test is a plain function call.
+using TestFunc = ResultType(*)();
+using TestFuncWithArg = ResultType(*)(std::istream&);
+
+// Gives the input for a TESTCASE_WITH_ARG test. It is only called when the test runs,
+// so the argument can be anything that converts to std::string, including strings built at runtime.
+using TestArgFunc = std::string(*)();
+
+// Parses a day's puzzle input ahead of its parts, so the runner can time the parse on its own.
+// See advent_parsed_input.h.
+using ParseFunc = ParseTiming(*)();
 
 struct TestExecutable
 {
 	TestFunc func;
-	ResultType execute() { return func(); }
-	explicit TestExecutable(TestFunc func_) : func{func_}{}
+	ResultType execute() const { return func(); }
 };
 
 struct TestWithArgExecutable
 {
 	TestFuncWithArg func;
-	std::string arg;
-	ResultType execute();
-	TestWithArgExecutable(TestFuncWithArg func_, std::string arg_) : func(func_) , arg(std::move(arg_)){}
+	TestArgFunc arg;
+	ResultType execute() const;
 };
 
 using Test = std::variant<TestExecutable,TestWithArgExecutable>;
 
+// A type to use to indicate the result is not known yet. Using this in a verification test
+// will run the test and report the result, but will count as neither pass nor failure.
+struct Dummy {};
+static constexpr Dummy dummy;
+
+// The expected result of a test: nothing (dummy), a number, or a string literal.
+class expected_result
+{
+	enum class kind : char { none, signed_number, unsigned_number, text };
+	kind m_kind = kind::none;
+	uint64_t m_number = 0;
+	std::string_view m_text;
+public:
+	constexpr expected_result(Dummy) noexcept {}
+
+	template <std::integral T>
+	constexpr expected_result(T number) noexcept
+		: m_kind{ std::signed_integral<T> ? kind::signed_number : kind::unsigned_number }
+		, m_number{ static_cast<uint64_t>(number) } {}
+
+	constexpr expected_result(std::string_view text) noexcept : m_kind{ kind::text }, m_text{ text } {}
+	constexpr expected_result(const char* text) noexcept : expected_result{ std::string_view{ text } } {}
+
+	constexpr bool has_value() const noexcept { return m_kind != kind::none; }
+
+	// Empty if there is no expected result.
+	std::string to_string() const;
+};
+
 // This describes a test to run.
 struct verification_test
 {
-	std::string name;
+	std::string_view name;
 	Test test_func;
-	std::optional<std::string> expected_result;
-	verification_test(std::string name_, TestFunc func) : verification_test{ std::move(name_), func, std::nullopt }{}
-	verification_test(std::string name_, TestFunc func, std::string result) : verification_test{std::move(name_), func, std::optional<std::string>{std::move(result)} }{}
-	verification_test(std::string name_, TestFuncWithArg func, std::string arg) : verification_test{ std::move(name_), func, std::move(arg), std::nullopt } {}
-	verification_test(std::string name_, TestFuncWithArg func, std::string arg, std::string result) : verification_test{ std::move(name_), func, std::move(arg), std::optional<std::string>{std::move(result)} } {}
-private:
-	verification_test(std::string n, TestFunc t, std::optional<std::string> r) : name(std::move(n)),test_func(TestExecutable{t}),expected_result(std::move(r)){} 
-	verification_test(std::string n, TestFuncWithArg t, std::string arg, std::optional<std::string> r) : name(std::move(n)),test_func(TestWithArgExecutable{t , std::move(arg)}),expected_result(std::move(r)){} 
+	expected_result expected;
+
+	// Set for the parts of a PARSED_DAY. The runner calls this before starting the clock.
+	ParseFunc parse = nullptr;
 };
 
-// A type to use to indicate the result is not known yet. Using this in a verification test
-// will run the test and report the result, but will count as neither pass nor failure.
-struct Dummy {};
-static constexpr Dummy dummy;
+constexpr verification_test make_test(std::string_view name, TestFunc func, expected_result expected)
+{
+	return verification_test{ name, TestExecutable{ func }, expected };
+}
 
-verification_test make_test(std::string name, TestFunc func, int64_t result);
-verification_test make_test(std::string name, TestFunc func, std::string result);
-verification_test make_test(std::string name, TestFunc func, Dummy);
+constexpr verification_test make_test(std::string_view name, TestFunc func, expected_result expected, ParseFunc parse)
+{
+	return verification_test{ name, TestExecutable{ func }, expected, parse };
+}
+
+constexpr verification_test make_test(std::string_view name, TestFuncWithArg func, expected_result expected, TestArgFunc arg)
+{
+	return verification_test{ name, TestWithArgExecutable{ func, arg }, expected };
+}
 
-verification_test make_test(std::string name, TestFuncWithArg func, int64_t result, std::string arg);
-verification_test make_test(std::string name, TestFuncWithArg func, std::string result, std::string arg);
-verification_test make_test(std::string name, TestFuncWithArg func, Dummy, std::string arg);
+// A solver to run on ever larger inputs with --scale, to see how its time and memory grow.
+// make_input returns an input scale times the size of a normal one. It is only called in scaling mode.
+using ScalingInputFunc = std::string(*)(std::size_t scale);
+
+struct scaling_test
+{
+	std::string_view name;
+	TestFuncWithArg func;
+	ScalingInputFunc make_input;
+};
+
+// Unlike a plain array, this can be empty.
+template <typename...Tests>
+constexpr std::array<scaling_test, sizeof...(Tests)> make_scaling_tests(Tests...scaling_tests)
+{
+	return std::array<scaling_test, sizeof...(Tests)>{ scaling_tests... };
+}
+
+// Another implementation of a day's part, e.g. an optimised version kept alongside the original.
+// The runner checks it gets the same result as the part in tests[] and shows how much faster it is.
+struct solver_variant
+{
+	std::string_view reference_name;	// The name of the test in tests[] it is a variant of.
+	std::string_view name;
+	TestFunc func;
+};
+
+template <typename...Variants>
+constexpr std::array<solver_variant, sizeof...(Variants)> make_variants(Variants...variants)
+{
+	return std::array<solver_variant, sizeof...(Variants)>{ variants... };
+}
 
-#define ARG(func_name) std::string{ #func_name },func_name
-#define ARG_WITH_PARAM(func_name,param) std::string{ #func_name "("  #param ")"  }, func_name
+#define ARG(func_name) std::string_view{ #func_name },func_name
+#define ARG_WITH_PARAM(func_name,param) std::string_view{ #func_name "("  #param ")"  }, func_name
 #define TESTCASE(func_name,expected_result) make_test(ARG(func_name),expected_result)
-#define TESTCASE_WITH_ARG(func_name,arg,expected_result) make_test(ARG_WITH_PARAM(func_name,arg),expected_result,arg)
+#define TESTCASE_WITH_ARG(func_name,arg,expected_result) make_test(ARG_WITH_PARAM(func_name,arg),expected_result,[]() -> std::string { return std::string{ arg }; })
+#define SCALING_TESTCASE(func_name,input_generator) scaling_test{ ARG(func_name),input_generator }
+#define VARIANT(day_num,part_num,name,func) solver_variant{ std::string_view{ "advent_" #day_num "_p" #part_num }, std::string_view{ #name }, func }
 #define FUNC_NAME(day_num,part_num) advent_ ## day_num ## _p ## part_num
 #define TEST_DECL(day_num,part_num,expected_result) TESTCASE(FUNC_NAME(day_num,part_num),expected_result)
 #define DAY(day_num,part1_result,part2_result) \
 	TEST_DECL(day_num,1,part1_result), \
-	TEST_DECL(day_num,2,part2_result)
\ No newline at end of file
+	TEST_DECL(day_num,2,part2_result)
+#define PARSE_FUNC_NAME(day_num) advent_ ## day_num ## _parse
+#define PARSED_TESTCASE(func_name,expected_result,parse_func) make_test(ARG(func_name),expected_result,parse_func)
+#define PARSED_TEST_DECL(day_num,part_num,expected_result) PARSED_TESTCASE(FUNC_NAME(day_num,part_num),expected_result,PARSE_FUNC_NAME(day_num))
+#define PARSED_DAY(day_num,part1_result,part2_result) \
+	PARSED_TEST_DECL(day_num,1,part1_result), \
+	PARSED_TEST_DECL(day_num,2,part2_result)
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include "advent_assert.h"
+
+namespace advent
+{
+	// Summary of repeated timings of the same piece of work.
+	struct timing_stats
+	{
+		std::size_t num_samples = 0;
+		std::chrono::nanoseconds min{ 0 };
+		std::chrono::nanoseconds median{ 0 };
+		std::chrono::nanoseconds mean{ 0 };
+		std::chrono::nanoseconds p95{ 0 };
+		std::chrono::nanoseconds max{ 0 };
+		std::chrono::nanoseconds stddev{ 0 };
+
+		// Standard deviation as a fraction of the mean. Useful for spotting noisy measurements.
+		double relative_stddev() const noexcept
+		{
+			return mean.count() > 0 ? static_cast<double>(stddev.count()) / static_cast<double>(mean.count()) : 0.0;
+		}
+	};
+
+	inline timing_stats calculate_timing_stats(std::vector<std::chrono::nanoseconds> samples)
+	{
+		timing_stats result;
+		result.num_samples = samples.size();
+		if (samples.empty())
+		{
+			return result;
+		}
+
+		std::ranges::sort(samples);
+		const std::size_t n = samples.size();
+		result.min = samples.front();
+		result.max = samples.back();
+		result.median = (n % 2 == 1) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+		// Nearest-rank percentile.
+		const auto p95_rank = static_cast<std::size_t>(std::ceil(0.95 * static_cast<double>(n)));
+		AdventCheck(p95_rank >= 1 && p95_rank <= n);
+		result.p95 = samples[p95_rank - 1];
+
+		const double total = std::transform_reduce(begin(samples), end(samples), 0.0, std::plus<double>{},
+			[](std::chrono::nanoseconds s) { return static_cast<double>(s.count()); });
+		const double mean = total / static_cast<double>(n);
+		const double sum_sq_diff = std::transform_reduce(begin(samples), end(samples), 0.0, std::plus<double>{},
+			[mean](std::chrono::nanoseconds s)
+			{
+				const double diff = static_cast<double>(s.count()) - mean;
+				return diff * diff;
+			});
+		const double variance = n > 1 ? sum_sq_diff / static_cast<double>(n - 1) : 0.0;
+		result.mean = std::chrono::nanoseconds{ std::llround(mean) };
+		result.stddev = std::chrono::nanoseconds{ std::llround(std::sqrt(variance)) };
+		return result;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <chrono>
+
+#include "advent_json.h"
+
+// Collects a timeline of the run in the Chrome trace event format, which can be loaded into
+// Perfetto (ui.perfetto.dev) or chrome://tracing. Used by --trace.
+// Every event is a span on the thread that produced it. Until enable() is called, nothing is recorded.
+namespace advent::trace
+{
+	using clock = std::chrono::high_resolution_clock;
+
+	void enable();
+	bool is_enabled() noexcept;
+
+	// The name and category are stored as views, so they must outlive the run: use string literals,
+	// or names that live in static storage such as the test names in tests[].
+	void add_span(std::string_view name, std::string_view category, clock::time_point start, clock::time_point end);
+
+	// Names the calling thread in the timeline. Naming it again replaces the old name.
+	void set_thread_name(std::string name);
+
+	// Stores a value under key in the file's "otherData", e.g. how the tests were scheduled.
+	void set_metadata(std::string key, json::value value);
+
+	// Returns false if the file could not be written.
+	bool write_file(const std::string& filename);
+}
@@ -4,8 +4,18 @@
 #include <variant>
 #include <cstdint>
 #include <ranges>
+#include <chrono>
 
 using ResultType = std::variant<std::string, int64_t, uint64_t>;
+
+// What a day's parse function (e.g. advent_one_parse) reports. reused is true if the input
+// had already been parsed, e.g. by the other part, and time is how long that parse took.
+struct ParseTiming
+{
+	std::chrono::nanoseconds time{ 0 };
+	bool reused = false;
+};
+
 enum class AdventDay
 {
 	one, two
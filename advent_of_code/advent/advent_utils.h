@@ -5,14 +5,116 @@
 #include <iostream>
 #include <filesystem>
 #include <format>
+#include <memory>
+#include <streambuf>
 
 #include "advent_assert.h"
+#include "advent_input_store.h"
+#include "advent_phases.h"
+#include "advent_profile.h"
 
 namespace advent
 {
-	inline std::ifstream open_input(const std::string& filename)
+	// A read-only stream buffer over memory owned by somebody else.
+	class memory_streambuf : public std::streambuf
 	{
-		auto result = std::ifstream{ filename };
+	public:
+		memory_streambuf(const char* data, std::size_t size) noexcept
+		{
+			char* start = const_cast<char*>(data);
+			setg(start, start, start + size);
+		}
+	protected:
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+		{
+			if (!(which & std::ios_base::in))
+			{
+				return pos_type(off_type(-1));
+			}
+			off_type base = 0;
+			switch (dir)
+			{
+			case std::ios_base::beg: base = 0; break;
+			case std::ios_base::cur: base = gptr() - eback(); break;
+			case std::ios_base::end: base = egptr() - eback(); break;
+			default: return pos_type(off_type(-1));
+			}
+			const off_type target = base + off;
+			if (target < 0 || target > egptr() - eback())
+			{
+				return pos_type(off_type(-1));
+			}
+			setg(eback(), eback() + target, egptr());
+			return pos_type(target);
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+		{
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+	};
+
+	// The stream returned by open_input. It reads from memory if the file has been
+	// loaded into the input store (the runner does this before timing starts), and from disk otherwise.
+	// Both read in text mode, so they give the same lines. It has std::ifstream's is_open and close,
+	// so only code that names the type std::ifstream needs changing to use auto or std::istream&.
+	class input_stream : public std::istream
+	{
+		std::shared_ptr<const std::string> m_data;
+		std::unique_ptr<std::streambuf> m_buf;
+	public:
+		explicit input_stream(std::shared_ptr<const std::string> data)
+			: std::istream{ nullptr }, m_data{ std::move(data) }
+			, m_buf{ std::make_unique<memory_streambuf>(m_data->data(), m_data->size()) }
+		{
+			rdbuf(m_buf.get());
+		}
+
+		explicit input_stream(const std::string& filename) : std::istream{ nullptr }
+		{
+			auto file = std::make_unique<std::filebuf>();
+			if (file->open(filename, std::ios_base::in))
+			{
+				m_buf = std::move(file);
+				rdbuf(m_buf.get());
+			}
+		}
+
+		input_stream(input_stream&& other) noexcept
+			: std::istream{ std::move(other) }, m_data{ std::move(other.m_data) }, m_buf{ std::move(other.m_buf) }
+		{
+			set_rdbuf(m_buf.get());
+		}
+
+		bool is_open() const noexcept { return m_buf != nullptr; }
+
+		// As std::ifstream::close, for code written when open_input returned one.
+		void close()
+		{
+			if (!is_open())
+			{
+				setstate(std::ios_base::failbit);
+			}
+			set_rdbuf(nullptr);
+			m_buf.reset();
+			m_data.reset();
+		}
+	};
+
+	inline input_stream open_input(const std::string& filename)
+	{
+		if (auto preloaded = input_store::find(filename))
+		{
+#ifndef NDEBUG
+			if (preloaded->empty())
+			{
+				std::cerr << "\nWARNING! File '" << filename << "' is empty.";
+			}
+#endif
+			return input_stream{ std::move(preloaded) };
+		}
+
+		auto result = input_stream{ filename };
 		AdventCheck(result.is_open());
 #ifndef NDEBUG
 		if (std::filesystem::file_size(filename) <= 0)
@@ -23,17 +125,39 @@ namespace advent
 		return result;
 	}
 
-	// Opens a file with the name "adventX/adventX.txt"
-	inline std::ifstream open_puzzle_input(int day)
+	// The name of the file open_puzzle_input opens.
+	inline std::string puzzle_input_filename(int day)
 	{
-		const std::string name = std::format("advent{0}/advent{0}.txt", day);
-		return open_input(name);
+		return std::format("advent{0}/advent{0}.txt", day);
+	}
+
+	// Opens a file with the name "adventX/adventX.txt", or in batch mode the file being run.
+	inline input_stream open_puzzle_input(int day)
+	{
+		if (auto overridden = input_store::get_puzzle_input_override())
+		{
+			return input_stream{ std::move(overridden) };
+		}
+		return open_input(puzzle_input_filename(day));
+	}
+
+	// The whole of the input open_puzzle_input would read, loading it into the input store if it isn't there yet.
+	inline std::shared_ptr<const std::string> load_puzzle_input(int day)
+	{
+		if (auto overridden = input_store::get_puzzle_input_override())
+		{
+			return overridden;
+		}
+		const std::string filename = puzzle_input_filename(day);
+		const bool loaded = input_store::preload(filename);
+		AdventCheckMsg(loaded, "Could not read", filename);
+		return input_store::find(filename);
 	}
 
 	// Open a file with the format "adventX/testcase_Y.txt"
-	inline std::ifstream open_testcase_input(int day, char id)
+	inline input_stream open_testcase_input(int day, char id)
 	{
 		const std::string name = std::format("advent{0}/testcast_{1}.txt", day, id);
 		return open_input(name);
 	}
-}
\ No newline at end of file
+}
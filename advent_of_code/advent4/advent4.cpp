@@ -27,7 +27,7 @@ namespace
 
 namespace
 {
-	int64_t solve_p1(std::istream& input)
+	int64_t solve_p1([[maybe_unused]] std::istream& input)
 	{
 		return 0;
 	}
@@ -35,7 +35,7 @@ namespace
 
 namespace
 {
-	int64_t solve_p2(std::istream& input)
+	int64_t solve_p2([[maybe_unused]] std::istream& input)
 	{
 		return 0;
 	}
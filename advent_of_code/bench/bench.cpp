@@ -0,0 +1,234 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <charconv>
+#include <cstdlib>
+#include <algorithm>
+
+#include "bench.h"
+#include "advent/advent_json.h"
+#include "advent/advent_test_result.h"
+
+namespace
+{
+	// Stop growing a sample past this, in case the work was optimised away and every call takes no time.
+	constexpr std::size_t MAX_ITERATIONS = std::size_t{ 1 } << 30;
+
+	[[noreturn]] void options_error(std::string_view message)
+	{
+		std::cerr << "Error: " << message << "\n"
+			"Usage: advent_bench [options] [filters...]\n"
+			"Options:\n"
+			"    --samples N        Take N timed samples of each benchmark. Default 15.\n"
+			"    --min-time MS      Make each sample last at least MS milliseconds. Default 5.\n"
+			"    --json FILE        Write the results to FILE as JSON.\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::size_t to_size(std::string_view option, std::string_view value)
+	{
+		std::size_t result = 0;
+		const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+		if (ec != std::errc{} || ptr != value.data() + value.size())
+		{
+			options_error(std::string{ option } + " expects a number but got '" + std::string{ value } + '\'');
+		}
+		return result;
+	}
+
+	// Picks a unit so that the number has a few digits before the point.
+	std::string format_time(double ns)
+	{
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(2);
+		if (ns < 1'000.0) oss << ns << "ns";
+		else if (ns < 1'000'000.0) oss << ns / 1'000.0 << "us";
+		else if (ns < 1'000'000'000.0) oss << ns / 1'000'000.0 << "ms";
+		else oss << ns / 1'000'000'000.0 << "s";
+		return oss.str();
+	}
+
+	std::string format_rate(double per_second)
+	{
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(1);
+		if (per_second < 1'000.0) oss << per_second << "/s";
+		else if (per_second < 1'000'000.0) oss << per_second / 1'000.0 << "K/s";
+		else if (per_second < 1'000'000'000.0) oss << per_second / 1'000'000.0 << "M/s";
+		else oss << per_second / 1'000'000'000.0 << "G/s";
+		return oss.str();
+	}
+
+	bool matches_filters(std::string_view name, const advent::bench::options& opts)
+	{
+		return opts.filters.empty() || std::ranges::any_of(opts.filters, [name](std::string_view filter)
+			{
+				return name.find(filter) < name.size();
+			});
+	}
+
+	void print_result(const advent::bench::result& r)
+	{
+		std::cout << std::left << std::setw(36) << r.name << std::right
+			<< std::setw(9) << r.size
+			<< std::setw(12) << format_time(r.median_ns())
+			<< std::setw(12) << format_time(r.min_ns())
+			<< std::setw(7) << std::fixed << std::setprecision(1) << 100.0 * r.per_sample.relative_stddev() << '%'
+			<< std::setw(12) << format_rate(r.throughput())
+			<< std::setw(12) << r.iterations << '\n';
+	}
+
+	advent::json::value to_json(const advent::bench::result& r)
+	{
+		advent::json::value v;
+		v.set("name", r.name);
+		v.set("size", r.size);
+		v.set("items", r.items);
+		v.set("iterations", r.iterations);
+		v.set("samples", r.per_sample.num_samples);
+		v.set("median_ns", r.median_ns());
+		v.set("min_ns", r.min_ns());
+		v.set("mean_ns", static_cast<double>(r.per_sample.mean.count()) / static_cast<double>(r.iterations));
+		v.set("p95_ns", static_cast<double>(r.per_sample.p95.count()) / static_cast<double>(r.iterations));
+		v.set("max_ns", static_cast<double>(r.per_sample.max.count()) / static_cast<double>(r.iterations));
+		v.set("relative_stddev", r.per_sample.relative_stddev());
+		v.set("items_per_second", r.throughput());
+		return v;
+	}
+}
+
+// advent2024 defines this alongside its runner. The profile scopes in utils (e.g. in grid.h) need it to link.
+std::string to_human_readable(std::chrono::nanoseconds time)
+{
+	return format_time(static_cast<double>(time.count()));
+}
+
+double advent::bench::result::throughput() const noexcept
+{
+	const double ns = median_ns();
+	return ns > 0.0 ? static_cast<double>(items) * 1e9 / ns : 0.0;
+}
+
+advent::bench::state::state(const options& opts, std::string_view name, std::size_t size)
+	: m_options{ opts }, m_size{ size }
+{
+	m_result.name = std::string{ name };
+	m_result.size = size;
+	m_result.items = size;
+}
+
+std::size_t advent::bench::state::next_iterations(std::size_t iterations, std::chrono::nanoseconds elapsed) const noexcept
+{
+	if (elapsed >= m_options.min_sample_time || iterations >= MAX_ITERATIONS)
+	{
+		return 0;
+	}
+
+	// Very short runs are mostly clock overhead, so don't trust them to predict the cost of a call.
+	if (elapsed * 10 < m_options.min_sample_time)
+	{
+		return std::min(iterations * 10, MAX_ITERATIONS);
+	}
+
+	// Aim a little over the target so the next try is very likely to be long enough.
+	const double scale = 1.2 * static_cast<double>(m_options.min_sample_time.count()) / static_cast<double>(std::max(elapsed.count(), int64_t{ 1 }));
+	const auto scaled = static_cast<std::size_t>(static_cast<double>(iterations) * scale);
+	return std::clamp(scaled, iterations + 1, MAX_ITERATIONS);
+}
+
+advent::bench::options advent::bench::parse_options(int argc, char** argv)
+{
+	options result;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		if (!arg.starts_with("--"))
+		{
+			result.filters.push_back(arg);
+			continue;
+		}
+
+		// Supports both "--option value" and "--option=value".
+		std::string_view value;
+		const auto equals = arg.find('=');
+		if (equals < arg.size())
+		{
+			value = arg.substr(equals + 1);
+			arg = arg.substr(0, equals);
+		}
+		auto get_value = [&]()
+		{
+			if (equals < std::string_view::npos) return value;
+			if (i + 1 >= argc)
+			{
+				options_error(std::string{ arg } + " expects a value");
+			}
+			return std::string_view{ argv[++i] };
+		};
+
+		if (arg == "--samples")
+		{
+			result.num_samples = std::max(to_size(arg, get_value()), std::size_t{ 1 });
+		}
+		else if (arg == "--min-time")
+		{
+			result.min_sample_time = std::chrono::milliseconds{ to_size(arg, get_value()) };
+		}
+		else if (arg == "--json")
+		{
+			result.json_file = std::string{ get_value() };
+		}
+		else
+		{
+			options_error("Unknown option " + std::string{ arg });
+		}
+	}
+	return result;
+}
+
+bool advent::bench::run_benchmarks(std::span<const benchmark> benchmarks, const options& opts)
+{
+	std::cout << std::left << std::setw(36) << "benchmark" << std::right
+		<< std::setw(9) << "size"
+		<< std::setw(12) << "median"
+		<< std::setw(12) << "min"
+		<< std::setw(8) << "rsd"
+		<< std::setw(12) << "items"
+		<< std::setw(12) << "iterations" << '\n';
+
+	std::vector<result> results;
+	for (const benchmark& b : benchmarks)
+	{
+		if (!matches_filters(b.name, opts))
+		{
+			continue;
+		}
+		for (std::size_t size : b.sizes)
+		{
+			state s{ opts, b.name, size };
+			b.func(s);
+			AdventCheckMsg(s.has_run(), "Benchmark never called state::run: ", b.name);
+			print_result(s.get_result());
+			results.push_back(s.get_result());
+		}
+	}
+
+	if (opts.json_file.empty())
+	{
+		return true;
+	}
+
+	json::array results_json;
+	std::ranges::transform(results, std::back_inserter(results_json), [](const result& r) { return to_json(r); });
+	json::value report;
+	report.set("samples", opts.num_samples);
+	report.set("min_sample_time_ms", std::chrono::duration_cast<std::chrono::milliseconds>(opts.min_sample_time).count());
+	report.set("benchmarks", std::move(results_json));
+	if (!json::write_file(opts.json_file, report))
+	{
+		std::cerr << "Could not write " << opts.json_file << '\n';
+		return false;
+	}
+	std::cout << "Wrote results to " << opts.json_file << '\n';
+	return true;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+#include "advent/advent_assert.h"
+#include "advent/advent_timing_stats.h"
+
+// A small micro-benchmark harness for the utils library, built as the advent_bench target.
+//
+//     void bench_to_value(advent::bench::state& state)
+//     {
+//         const std::vector<std::string> numbers = make_numbers(state.size());
+//         state.run([&numbers]()
+//             {
+//                 int64_t total = 0;
+//                 for (const std::string& n : numbers) total += utils::to_value<int64_t>(n);
+//                 return total;
+//             });
+//     }
+//
+// Each benchmark runs once per size it lists. Setup happens outside run(), which only times the lambda.
+// The lambda's return value is kept alive with do_not_optimize so the work can't be optimised away.
+namespace advent::bench
+{
+	using clock = std::chrono::high_resolution_clock;
+
+	struct options
+	{
+		std::vector<std::string_view> filters;
+		std::size_t num_samples = 15;
+		std::chrono::nanoseconds min_sample_time = std::chrono::milliseconds{ 5 };
+		std::string json_file;
+	};
+
+	struct result
+	{
+		std::string name;
+		std::size_t size = 0;
+		std::size_t items = 0;	// Handled by each call. The size unless the benchmark says otherwise.
+		std::size_t iterations = 0;	// Per sample.
+		timing_stats per_sample;
+
+		// Times for a single call of the benchmarked lambda, which may be well under a nanosecond.
+		double median_ns() const noexcept { return static_cast<double>(per_sample.median.count()) / static_cast<double>(iterations); }
+		double min_ns() const noexcept { return static_cast<double>(per_sample.min.count()) / static_cast<double>(iterations); }
+
+		// Items per second.
+		double throughput() const noexcept;
+	};
+
+	// Stops the compiler from discarding a value, or the work that produced it.
+	template <typename T>
+	inline void do_not_optimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static const volatile void* sink = nullptr;
+		sink = &value;
+#endif
+	}
+
+	class state
+	{
+		const options& m_options;
+		std::size_t m_size;
+		result m_result;
+		bool m_ran = false;
+
+		// Times iterations calls. Used for both calibrating and sampling so the loop is the same for both.
+		template <typename Fn>
+		std::chrono::nanoseconds time_iterations(Fn& fn, std::size_t iterations)
+		{
+			const auto start = clock::now();
+			for (std::size_t i = 0; i < iterations; ++i)
+			{
+				if constexpr (std::is_void_v<decltype(fn())>)
+				{
+					fn();
+				}
+				else
+				{
+					do_not_optimize(fn());
+				}
+			}
+			return clock::now() - start;
+		}
+
+		// How many iterations to try next, given that the last try took elapsed. Returns 0 once a sample is long enough.
+		std::size_t next_iterations(std::size_t iterations, std::chrono::nanoseconds elapsed) const noexcept;
+	public:
+		state(const options& opts, std::string_view name, std::size_t size);
+
+		std::size_t size() const noexcept { return m_size; }
+
+		// For when a call handles something other than size items, e.g. a grid with sides of length size.
+		void set_items(std::size_t items) noexcept { m_result.items = items; }
+
+		// Times fn. Call it exactly once per benchmark.
+		template <typename Fn>
+		void run(Fn&& fn)
+		{
+			AdventCheckMsg(!m_ran, "state::run called twice in one benchmark");
+			m_ran = true;
+
+			// Find how many calls make a sample long enough to time reliably.
+			// This also warms the caches and branch predictor before any samples are taken.
+			std::size_t iterations = 1;
+			while (const std::size_t next = next_iterations(iterations, time_iterations(fn, iterations)))
+			{
+				iterations = next;
+			}
+
+			std::vector<std::chrono::nanoseconds> samples;
+			samples.reserve(m_options.num_samples);
+			for (std::size_t i = 0; i < m_options.num_samples; ++i)
+			{
+				samples.push_back(time_iterations(fn, iterations));
+			}
+			m_result.iterations = iterations;
+			m_result.per_sample = calculate_timing_stats(std::move(samples));
+		}
+
+		bool has_run() const noexcept { return m_ran; }
+		const result& get_result() const noexcept { return m_result; }
+	};
+
+	struct benchmark
+	{
+		std::string_view name;
+		void(*func)(state&);
+		std::span<const std::size_t> sizes;
+	};
+
+	// Parses the command line in the same style as advent2024. Exits with usage on an error.
+	options parse_options(int argc, char** argv);
+
+	// Runs every benchmark whose name contains one of the filters, or all of them with no filters.
+	// Returns false if the JSON file couldn't be written.
+	bool run_benchmarks(std::span<const benchmark> benchmarks, const options& opts);
+}
@@ -0,0 +1,13 @@
+#include "bench.h"
+#include "bench_utils.h"
+
+#include <cstdlib>
+
+int main(int argc, char** argv)
+{
+	// Like advent2024, arguments are filters on the benchmark names unless they start with "--".
+	// E.g. "advent_bench sorted_vector --json before.json" runs the sorted_vector benchmarks and saves the results.
+	const advent::bench::options options = advent::bench::parse_options(argc, argv);
+	const bool success = advent::bench::run_benchmarks(advent::bench::get_utils_benchmarks(), options);
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
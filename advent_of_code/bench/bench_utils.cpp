@@ -0,0 +1,378 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <random>
+#include <optional>
+#include <cstdint>
+#include <cassert>
+
+#include "bench.h"
+#include "bench_utils.h"
+
+// The utils headers rely on the aliases and includes the solutions get from these.
+#include "advent/advent_types.h"
+#include "advent/advent_utils.h"
+
+#include "utils/small_vector.h"
+#include "utils/sorted_vector.h"
+#include "utils/grid.h"
+#include "utils/to_value.h"
+#include "utils/split_string.h"
+#include "utils/istream_line_iterator.h"
+#include "utils/buffer_line_iterator.h"
+#include "utils/istream_block_iterator.h"
+#include "utils/buffer_block_iterator.h"
+#include "utils/line_index.h"
+#include "utils/parallel_parse.h"
+#include "utils/md5.h"
+#include "utils/a_star.h"
+
+namespace
+{
+	using advent::bench::state;
+
+	// Fixed seed so every run works on the same data.
+	std::mt19937 make_rng()
+	{
+		return std::mt19937{ 2024 };
+	}
+
+	std::vector<int> make_random_ints(std::size_t count)
+	{
+		auto rng = make_rng();
+		std::uniform_int_distribution<int> dist{ 0, 1'000'000 };
+		std::vector<int> result(count);
+		for (int& i : result) i = dist(rng);
+		return result;
+	}
+
+	// A square grid with about one wall in five. The top row and right column are left open
+	// so there's always a path between opposite corners, but rarely a straight one.
+	std::string make_grid_text(std::size_t side)
+	{
+		auto rng = make_rng();
+		std::bernoulli_distribution is_wall{ 0.2 };
+		std::string result;
+		result.reserve(side * (side + 1));
+		for (std::size_t y = 0; y < side; ++y)
+		{
+			// Like a trimmed puzzle input, there's no newline after the last row.
+			if (y != 0) result.push_back('\n');
+			for (std::size_t x = 0; x < side; ++x)
+			{
+				const bool open = (y == 0) || (x + 1 == side);
+				result.push_back(!open && is_wall(rng) ? '#' : '.');
+			}
+		}
+		return result;
+	}
+
+	utils::grid<char> make_grid(std::size_t side)
+	{
+		std::istringstream iss{ make_grid_text(side) };
+		return utils::grid_helpers::build(iss, [](char c) { return c; });
+	}
+
+	void small_vector_push_back(state& s)
+	{
+		s.run([size = s.size()]()
+			{
+				utils::small_vector<int, 16> v;
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					v.push_back(static_cast<int>(i));
+				}
+				return v.size();
+			});
+	}
+
+	void small_vector_copy(state& s)
+	{
+		const std::vector<int> values = make_random_ints(s.size());
+		const utils::small_vector<int, 16> source(begin(values), end(values));
+		s.run([&source]()
+			{
+				const utils::small_vector<int, 16> copy = source;
+				return copy.size();
+			});
+	}
+
+	void sorted_vector_insert(state& s)
+	{
+		const std::vector<int> values = make_random_ints(s.size());
+		s.run([&values]()
+			{
+				utils::sorted_vector<int> v;
+				for (int i : values)
+				{
+					v.insert(i);
+				}
+				// The first lookup sorts everything inserted so far.
+				return v.contains(values.front());
+			});
+	}
+
+	void sorted_vector_find(state& s)
+	{
+		const std::vector<int> values = make_random_ints(s.size());
+		const utils::sorted_vector<int> v(begin(values), end(values));
+		v.contains(0);
+		s.run([&values, &v]()
+			{
+				std::size_t found = 0;
+				for (int i : values)
+				{
+					found += v.contains(i + (i & 1)) ? 1 : 0;
+				}
+				return found;
+			});
+	}
+
+	void grid_build(state& s)
+	{
+		s.set_items(s.size() * s.size());
+		const std::string text = make_grid_text(s.size());
+		s.run([&text]()
+			{
+				std::istringstream iss{ text };
+				const auto g = utils::grid_helpers::build(iss, [](char c) { return c; });
+				return g.get_max_point();
+			});
+	}
+
+	void grid_build_from_buffer(state& s)
+	{
+		s.set_items(s.size() * s.size());
+		const std::string text = make_grid_text(s.size());
+		s.run([&text]()
+			{
+				const auto g = utils::grid_helpers::build(std::string_view{ text }, [](char c) { return c; });
+				return g.get_max_point();
+			});
+	}
+
+	// Lines of about 40 characters, like a typical puzzle input.
+	std::string make_lines_text(std::size_t num_lines)
+	{
+		std::string result;
+		for (int i : make_random_ints(num_lines * 5))
+		{
+			result += std::to_string(i);
+			result.push_back(result.size() % 40 < 8 ? '\n' : ' ');
+		}
+		return result;
+	}
+
+	void lines_istream(state& s)
+	{
+		const std::string text = make_lines_text(s.size());
+		s.run([&text]()
+			{
+				std::istringstream iss{ text };
+				std::size_t total = 0;
+				for (std::string_view line : utils::istream_line_range{ iss })
+				{
+					total += line.size();
+				}
+				return total;
+			});
+	}
+
+	void lines_buffer(state& s)
+	{
+		const std::string text = make_lines_text(s.size());
+		s.run([&text]()
+			{
+				std::size_t total = 0;
+				for (std::string_view line : utils::buffer_line_range{ text })
+				{
+					total += line.size();
+				}
+				return total;
+			});
+	}
+
+	// Same work as lines/buffer, spread over a thread per core once the input is big enough.
+	void lines_parallel_parse(state& s)
+	{
+		const std::string text = make_lines_text(s.size());
+		s.run([&text]()
+			{
+				return utils::parallel_parse(text, [](std::string_view line) { return line.size(); }, std::plus<>{});
+			});
+	}
+
+	// Blocks of a few lines separated by blank lines, like the puzzles with several sections per item.
+	std::string make_blocks_text(std::size_t num_blocks)
+	{
+		std::string result;
+		const std::vector<int> values = make_random_ints(num_blocks * 4);
+		for (std::size_t i = 0; i < values.size(); ++i)
+		{
+			if (i != 0) result += (i % 4 == 0) ? "\n\n" : "\n";
+			result += std::to_string(values[i]);
+		}
+		return result;
+	}
+
+	void blocks_istream(state& s)
+	{
+		const std::string text = make_blocks_text(s.size());
+		s.run([&text]()
+			{
+				std::istringstream iss{ text };
+				std::size_t total = 0;
+				for (std::string_view block : utils::istream_block_range{ iss })
+				{
+					total += block.size();
+				}
+				return total;
+			});
+	}
+
+	void blocks_buffer(state& s)
+	{
+		const std::string text = make_blocks_text(s.size());
+		s.run([&text]()
+			{
+				std::size_t total = 0;
+				for (std::string_view block : utils::buffer_block_range{ text })
+				{
+					total += block.size();
+				}
+				return total;
+			});
+	}
+
+	void line_index_build(state& s)
+	{
+		const std::string text = make_lines_text(s.size());
+		s.run([&text]()
+			{
+				return utils::line_index{ text }.size();
+			});
+	}
+
+	void grid_get_path(state& s)
+	{
+		s.set_items(s.size() * s.size());
+		const utils::grid<char> g = make_grid(s.size());
+		const utils::coords end_point = g.get_max_point() - utils::coords{ 1, 1 };
+		auto cost_fn = [](utils::coords, char, utils::coords, char to) -> std::optional<float>
+		{
+			return to == '#' ? std::nullopt : std::optional<float>{ 1.0f };
+		};
+		s.run([&g, &end_point, &cost_fn]()
+			{
+				return g.get_path(utils::coords{ 0, 0 }, end_point, cost_fn).size();
+			});
+	}
+
+	void to_value_int64(state& s)
+	{
+		auto rng = make_rng();
+		std::uniform_int_distribution<int64_t> dist{ -1'000'000'000'000, 1'000'000'000'000 };
+		std::vector<std::string> numbers(s.size());
+		for (std::string& n : numbers) n = std::to_string(dist(rng));
+		s.run([&numbers]()
+			{
+				int64_t total = 0;
+				for (const std::string& n : numbers)
+				{
+					total += utils::to_value<int64_t>(n);
+				}
+				return total;
+			});
+	}
+
+	void split_string_char(state& s)
+	{
+		std::string line;
+		for (int i : make_random_ints(s.size()))
+		{
+			if (!line.empty()) line.push_back(',');
+			line += std::to_string(i);
+		}
+		s.run([&line]()
+			{
+				return utils::split_string(line, ',').size();
+			});
+	}
+
+	void md5_get_digest(state& s)
+	{
+		auto rng = make_rng();
+		std::uniform_int_distribution<int> dist{ 'a', 'z' };
+		std::string message(s.size(), ' ');
+		for (char& c : message) c = static_cast<char>(dist(rng));
+		s.run([&message]()
+			{
+				return utils::get_digest(message).get_word(0);
+			});
+	}
+
+	void a_star_grid(state& s)
+	{
+		s.set_items(s.size() * s.size());
+		const utils::grid<char> g = make_grid(s.size());
+		const utils::coords end_point = g.get_max_point() - utils::coords{ 1, 1 };
+		auto get_next = [&g](const utils::coords& c)
+		{
+			utils::small_vector<utils::coords, 4> result;
+			for (utils::coords dir : { utils::coords::up(), utils::coords::down(), utils::coords::left(), utils::coords::right() })
+			{
+				const utils::coords next = c + dir;
+				if (g.is_on_grid(next) && g.at(next) != '#')
+				{
+					result.push_back(next);
+				}
+			}
+			return result;
+		};
+		s.run([&]()
+			{
+				const auto path = utils::a_star(utils::coords{ 0, 0 },
+					[&end_point](const utils::coords& c) { return c == end_point; },
+					get_next,
+					[](const utils::coords&, const utils::coords&) { return 1; },
+					[&end_point](const utils::coords& c) { return c.manhatten_distance(end_point); },
+					[](const utils::coords& l, const utils::coords& r) { return l == r; },
+					g.get_max_point().x * g.get_max_point().y);
+				return path.first.size();
+			});
+	}
+
+	// Element counts for the containers and parsers, and side lengths for the grids.
+	constexpr std::size_t ELEMENT_SIZES[] = { 8, 64, 1024, 16384 };
+	constexpr std::size_t BYTE_SIZES[] = { 16, 256, 4096, 65536 };
+	constexpr std::size_t GRID_SIZES[] = { 16, 64, 256 };
+
+	// a_star checks every visited node for each new one, so it's quadratic in the grid area.
+	constexpr std::size_t A_STAR_SIZES[] = { 8, 16, 32, 64 };
+
+	constexpr advent::bench::benchmark BENCHMARKS[] =
+	{
+		{ "small_vector/push_back", small_vector_push_back, ELEMENT_SIZES },
+		{ "small_vector/copy", small_vector_copy, ELEMENT_SIZES },
+		{ "sorted_vector/insert", sorted_vector_insert, ELEMENT_SIZES },
+		{ "sorted_vector/find", sorted_vector_find, ELEMENT_SIZES },
+		{ "grid/build", grid_build, GRID_SIZES },
+		{ "grid/build_from_buffer", grid_build_from_buffer, GRID_SIZES },
+		{ "grid/get_path", grid_get_path, GRID_SIZES },
+		{ "lines/istream", lines_istream, ELEMENT_SIZES },
+		{ "lines/buffer", lines_buffer, ELEMENT_SIZES },
+		{ "lines/parallel_parse", lines_parallel_parse, ELEMENT_SIZES },
+		{ "line_index/build", line_index_build, ELEMENT_SIZES },
+		{ "blocks/istream", blocks_istream, ELEMENT_SIZES },
+		{ "blocks/buffer", blocks_buffer, ELEMENT_SIZES },
+		{ "to_value/int64", to_value_int64, ELEMENT_SIZES },
+		{ "split_string/char", split_string_char, ELEMENT_SIZES },
+		{ "md5/get_digest", md5_get_digest, BYTE_SIZES },
+		{ "a_star/grid", a_star_grid, A_STAR_SIZES },
+	};
+}
+
+std::span<const advent::bench::benchmark> advent::bench::get_utils_benchmarks()
+{
+	return BENCHMARKS;
+}
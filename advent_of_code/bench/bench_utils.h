@@ -0,0 +1,11 @@
+#pragma once
+
+#include <span>
+
+#include "bench.h"
+
+namespace advent::bench
+{
+	// Benchmarks for the utils library, each over a few sizes.
+	std::span<const benchmark> get_utils_benchmarks();
+}
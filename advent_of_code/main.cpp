@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <vector>
+#include <cstdlib>
 
 int main(int argc, char** argv)
 {
@@ -11,17 +12,17 @@ int main(int argc, char** argv)
 	// and advent_eighteen_p2() (as well as any other test functions with "eighteen"
 	// in the function name.
 	// Leave blank to run everything.
-	std::vector<std::string_view> filters;
-	for(int i=1;i<argc;++i)
-	{
-		filters.push_back(argv[i]);
-	}
+	// Arguments starting with "--" are options instead. E.g. "--jobs 8" runs eight tests at once.
+	const run_options options = parse_run_options(argc, argv);
 
-	verify_all(filters);
+	const bool success = verify_all(options);
 
 #ifndef WIN32
-	std::cout << "Program finished. Press any key to continue.";
-	std::cin.get();
+	if (options.isolated_child_test.empty())
+	{
+		std::cout << "Program finished. Press any key to continue.";
+		std::cin.get();
+	}
 #endif
-	return 0;
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
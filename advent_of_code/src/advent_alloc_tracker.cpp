@@ -0,0 +1,221 @@
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "../advent/advent_alloc_tracker.h"
+
+#ifndef ADVENT_TRACK_ALLOCATIONS
+#define ADVENT_TRACK_ALLOCATIONS 0
+#endif
+
+namespace
+{
+	// Process-wide, so allocations from any thread a test starts (std::execution policies,
+	// utils::parallel_parse, ...) are counted. Only updated while some thread is tracking.
+	// Plain atomics only, so using these from inside operator new can't recurse into an allocation.
+	std::atomic<uint32_t> num_tracking{ 0 };
+	std::atomic<uint64_t> num_allocations{ 0 };
+	std::atomic<uint64_t> bytes_allocated{ 0 };
+
+	// Only blocks allocated since the last reset count towards this, so freeing memory from before
+	// (e.g. the preloaded input) doesn't hide what the test itself has live.
+	std::atomic<int64_t> live_bytes{ 0 };
+	std::atomic<uint64_t> generation{ 1 };
+	std::atomic<int64_t> peak_live_bytes{ 0 };
+
+	// Where the counters were when the calling thread started tracking.
+	struct tracking_start
+	{
+		bool active;
+		uint64_t num_allocations;
+		uint64_t bytes_allocated;
+	};
+	thread_local tracking_start this_thread_start{};
+}
+
+std::string advent::bytes_to_human_readable(uint64_t bytes)
+{
+	constexpr std::array suffixes{ "B", "KB", "MB", "GB", "TB" };
+	double value = static_cast<double>(bytes);
+	std::size_t suffix_idx = 0;
+	while (value >= 1024.0 && suffix_idx + 1 < suffixes.size())
+	{
+		value /= 1024.0;
+		++suffix_idx;
+	}
+	std::ostringstream oss;
+	if (suffix_idx == 0)
+	{
+		oss << bytes << suffixes[0];
+	}
+	else
+	{
+		oss << std::setprecision(3) << value << suffixes[suffix_idx];
+	}
+	return oss.str();
+}
+
+std::string advent::to_human_readable(const allocation_stats& stats)
+{
+	std::ostringstream oss;
+	oss << "allocations=" << stats.num_allocations
+		<< " allocated=" << bytes_to_human_readable(stats.bytes_allocated)
+		<< " peak=" << bytes_to_human_readable(stats.peak_live_bytes);
+	return oss.str();
+}
+
+bool advent::allocation_tracking_enabled() noexcept
+{
+	return ADVENT_TRACK_ALLOCATIONS != 0;
+}
+
+void advent::start_allocation_tracking() noexcept
+{
+	// Only reset when nothing else is being tracked, so overlapping tests (with --jobs) don't wipe each other's counts.
+	if (num_tracking.load() == 0)
+	{
+		num_allocations = 0;
+		bytes_allocated = 0;
+		live_bytes = 0;
+		peak_live_bytes = 0;
+		generation.fetch_add(1);
+	}
+	this_thread_start = tracking_start{ true, num_allocations.load(), bytes_allocated.load() };
+	num_tracking.fetch_add(1);
+}
+
+advent::allocation_stats advent::stop_allocation_tracking() noexcept
+{
+	if (!this_thread_start.active)
+	{
+		return allocation_stats{};
+	}
+	const allocation_stats result{
+		num_allocations.load() - this_thread_start.num_allocations,
+		bytes_allocated.load() - this_thread_start.bytes_allocated,
+		static_cast<uint64_t>(std::max(peak_live_bytes.load(), int64_t{ 0 }))
+	};
+	this_thread_start.active = false;
+	num_tracking.fetch_sub(1);
+	return result;
+}
+
+#if ADVENT_TRACK_ALLOCATIONS
+
+namespace
+{
+	bool is_tracking() noexcept
+	{
+		return num_tracking.load(std::memory_order_relaxed) != 0;
+	}
+
+	void update_peak(int64_t live) noexcept
+	{
+		int64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+		while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	// Stored just before every block we hand out, so delete knows the size and where the block really starts.
+	struct alloc_header
+	{
+		void* raw;
+		std::size_t size;
+		uint64_t generation;	// 0 if allocated while not tracking.
+	};
+
+	// Rounded up so that malloc's alignment is kept for the block after the header.
+	constexpr std::size_t HEADER_SPACE = (sizeof(alloc_header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+	alloc_header* get_header(void* ptr) noexcept
+	{
+		return static_cast<alloc_header*>(ptr) - 1;
+	}
+
+	void* tracked_alloc(std::size_t size, std::size_t alignment) noexcept
+	{
+		alignment = std::max(alignment, alignof(std::max_align_t));
+		const std::size_t extra = HEADER_SPACE + (alignment > alignof(std::max_align_t) ? alignment : 0);
+		void* raw = std::malloc(size + extra);
+		if (raw == nullptr)
+		{
+			return nullptr;
+		}
+		const auto raw_addr = reinterpret_cast<std::uintptr_t>(raw);
+		const auto user_addr = (raw_addr + HEADER_SPACE + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+		void* user = reinterpret_cast<void*>(user_addr);
+		*get_header(user) = alloc_header{ raw, size, 0 };
+
+		if (is_tracking())
+		{
+			get_header(user)->generation = generation.load(std::memory_order_relaxed);
+			num_allocations.fetch_add(1, std::memory_order_relaxed);
+			bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+			const int64_t size_signed = static_cast<int64_t>(size);
+			update_peak(live_bytes.fetch_add(size_signed, std::memory_order_relaxed) + size_signed);
+		}
+		return user;
+	}
+
+	void tracked_free(void* ptr) noexcept
+	{
+		if (ptr == nullptr)
+		{
+			return;
+		}
+		const alloc_header header = *get_header(ptr);
+		if (is_tracking() && header.generation == generation.load(std::memory_order_relaxed))
+		{
+			live_bytes.fetch_sub(static_cast<int64_t>(header.size), std::memory_order_relaxed);
+		}
+		std::free(header.raw);
+	}
+
+	void* tracked_alloc_or_throw(std::size_t size, std::size_t alignment)
+	{
+		while (true)
+		{
+			if (void* result = tracked_alloc(size, alignment))
+			{
+				return result;
+			}
+			std::new_handler handler = std::get_new_handler();
+			if (handler == nullptr)
+			{
+				throw std::bad_alloc{};
+			}
+			handler();
+		}
+	}
+}
+
+void* operator new(std::size_t size) { return tracked_alloc_or_throw(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return tracked_alloc_or_throw(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return tracked_alloc(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return tracked_alloc(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t al) { return tracked_alloc_or_throw(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return tracked_alloc_or_throw(size, static_cast<std::size_t>(al)); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return tracked_alloc(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return tracked_alloc(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void* ptr) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+
+#endif
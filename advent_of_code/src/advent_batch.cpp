@@ -0,0 +1,142 @@
+#include <sstream>
+#include <algorithm>
+#include <system_error>
+
+#include "../advent/advent_batch.h"
+#include "../advent/advent_alloc_tracker.h"
+#include "../advent/advent_test_result.h"
+
+namespace
+{
+	bool has_wildcards(std::string_view text) noexcept
+	{
+		return text.find_first_of("*?") < text.size();
+	}
+}
+
+bool advent::wildcard_match(std::string_view pattern, std::string_view text) noexcept
+{
+	// Greedy match with backtracking to the most recent *, which is enough for filename patterns.
+	std::size_t p = 0, t = 0;
+	std::size_t star = std::string_view::npos, star_text = 0;
+	while (t < text.size())
+	{
+		if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t]))
+		{
+			++p;
+			++t;
+		}
+		else if (p < pattern.size() && pattern[p] == '*')
+		{
+			star = p++;
+			star_text = t;
+		}
+		else if (star != std::string_view::npos)
+		{
+			p = star + 1;
+			t = ++star_text;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	while (p < pattern.size() && pattern[p] == '*')
+	{
+		++p;
+	}
+	return p == pattern.size();
+}
+
+std::vector<std::filesystem::path> advent::expand_batch_path(const std::string& path)
+{
+	namespace fs = std::filesystem;
+	std::vector<fs::path> result;
+	std::error_code ec;
+	const fs::path as_path{ path };
+
+	fs::path dir = as_path;
+	std::string pattern = "*";
+	if (!fs::is_directory(as_path, ec))
+	{
+		const std::string filename = as_path.filename().string();
+		if (!has_wildcards(filename))
+		{
+			if (fs::is_regular_file(as_path, ec))
+			{
+				result.push_back(as_path);
+			}
+			return result;
+		}
+		dir = as_path.has_parent_path() ? as_path.parent_path() : fs::path{ "." };
+		pattern = filename;
+	}
+
+	for (const fs::directory_entry& entry : fs::directory_iterator{ dir, ec })
+	{
+		if (entry.is_regular_file(ec) && wildcard_match(pattern, entry.path().filename().string()))
+		{
+			result.push_back(entry.path());
+		}
+	}
+	std::ranges::sort(result);
+	return result;
+}
+
+double advent::batch_summary::files_per_second() const noexcept
+{
+	const double seconds = std::chrono::duration<double>(wall_time).count();
+	return seconds > 0.0 ? static_cast<double>(num_files) / seconds : 0.0;
+}
+
+double advent::batch_summary::megabytes_per_second() const noexcept
+{
+	const double seconds = std::chrono::duration<double>(wall_time).count();
+	return seconds > 0.0 ? static_cast<double>(total_bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+advent::batch_summary advent::summarise_batch(std::span<const batch_file_result> results, std::chrono::nanoseconds wall_time)
+{
+	batch_summary summary;
+	summary.wall_time = wall_time;
+	for (const batch_file_result& file : results)
+	{
+		++summary.num_files;
+		summary.total_bytes += file.bytes;
+		const bool any_error = file.read_error || std::ranges::any_of(file.tests, &batch_test_result::error);
+		if (any_error)
+		{
+			++summary.num_errors;
+		}
+		summary.solve_time += file.parse_time;
+		for (const batch_test_result& test : file.tests)
+		{
+			summary.solve_time += test.time;
+		}
+	}
+	return summary;
+}
+
+std::string advent::to_human_readable(const batch_file_result& result)
+{
+	std::ostringstream oss;
+	oss << result.filename << " (" << bytes_to_human_readable(result.bytes) << "):";
+	if (result.read_error)
+	{
+		oss << " could not be read";
+	}
+	if (result.parse_time.count() > 0)
+	{
+		oss << " parse=" << ::to_human_readable(result.parse_time);
+	}
+	for (const batch_test_result& test : result.tests)
+	{
+		oss << ' ' << test.test_name << '=' << test.result;
+		if (test.error)
+		{
+			oss << " [ERROR]";
+		}
+		oss << " (" << ::to_human_readable(test.time) << ')';
+	}
+	return oss.str();
+}
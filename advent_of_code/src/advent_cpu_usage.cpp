@@ -0,0 +1,126 @@
+#include <sstream>
+#include <iomanip>
+
+#include "../advent/advent_cpu_usage.h"
+#include "../advent/advent_test_result.h"
+
+#ifdef __linux__
+#include <ctime>
+#include <sys/resource.h>
+#endif
+
+using advent::cpu_usage;
+
+namespace
+{
+#ifdef __linux__
+	std::chrono::nanoseconds to_nanoseconds(const timeval& tv) noexcept
+	{
+		return std::chrono::seconds{ tv.tv_sec } + std::chrono::microseconds{ tv.tv_usec };
+	}
+#endif
+
+	// Everything but the wall time, read right now.
+	cpu_usage read_cpu_usage() noexcept
+	{
+		cpu_usage result;
+#ifdef __linux__
+		timespec ts{};
+		if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+		{
+			result.thread_cpu = std::chrono::seconds{ ts.tv_sec } + std::chrono::nanoseconds{ ts.tv_nsec };
+		}
+		rusage usage{};
+		if (getrusage(RUSAGE_SELF, &usage) == 0)
+		{
+			result.process_user = to_nanoseconds(usage.ru_utime);
+			result.process_system = to_nanoseconds(usage.ru_stime);
+			result.voluntary_switches = static_cast<uint64_t>(usage.ru_nvcsw);
+			result.involuntary_switches = static_cast<uint64_t>(usage.ru_nivcsw);
+			result.minor_faults = static_cast<uint64_t>(usage.ru_minflt);
+			result.major_faults = static_cast<uint64_t>(usage.ru_majflt);
+		}
+#endif
+		return result;
+	}
+}
+
+double cpu_usage::parallelism() const noexcept
+{
+	return wall.count() > 0 ? static_cast<double>(process_cpu().count()) / static_cast<double>(wall.count()) : 0.0;
+}
+
+cpu_usage& cpu_usage::operator+=(const cpu_usage& other) noexcept
+{
+	wall += other.wall;
+	thread_cpu += other.thread_cpu;
+	process_user += other.process_user;
+	process_system += other.process_system;
+	voluntary_switches += other.voluntary_switches;
+	involuntary_switches += other.involuntary_switches;
+	minor_faults += other.minor_faults;
+	major_faults += other.major_faults;
+	return *this;
+}
+
+cpu_usage& cpu_usage::operator/=(uint64_t divisor) noexcept
+{
+	if (divisor == 0)
+	{
+		return *this;
+	}
+	const auto d = static_cast<std::chrono::nanoseconds::rep>(divisor);
+	wall /= d;
+	thread_cpu /= d;
+	process_user /= d;
+	process_system /= d;
+	voluntary_switches /= divisor;
+	involuntary_switches /= divisor;
+	minor_faults /= divisor;
+	major_faults /= divisor;
+	return *this;
+}
+
+std::string advent::to_human_readable(const cpu_usage& usage)
+{
+	std::ostringstream oss;
+	oss << "wall=" << ::to_human_readable(usage.wall)
+		<< " thread-cpu=" << ::to_human_readable(usage.thread_cpu)
+		<< " process-cpu=" << ::to_human_readable(usage.process_cpu())
+		<< " (user=" << ::to_human_readable(usage.process_user) << " sys=" << ::to_human_readable(usage.process_system) << ')'
+		<< " parallelism=" << std::fixed << std::setprecision(2) << usage.parallelism() << std::defaultfloat
+		<< " ctx-switches=" << usage.voluntary_switches << '+' << usage.involuntary_switches
+		<< " page-faults=" << usage.minor_faults << '+' << usage.major_faults;
+	return oss.str();
+}
+
+bool advent::is_cpu_usage_available() noexcept
+{
+#ifdef __linux__
+	return true;
+#else
+	return false;
+#endif
+}
+
+void advent::cpu_usage_meter::start() noexcept
+{
+	m_start = read_cpu_usage();
+	m_start_time = std::chrono::high_resolution_clock::now();
+}
+
+cpu_usage advent::cpu_usage_meter::stop() const noexcept
+{
+	const auto end_time = std::chrono::high_resolution_clock::now();
+	const cpu_usage end = read_cpu_usage();
+	cpu_usage result;
+	result.wall = end_time - m_start_time;
+	result.thread_cpu = end.thread_cpu - m_start.thread_cpu;
+	result.process_user = end.process_user - m_start.process_user;
+	result.process_system = end.process_system - m_start.process_system;
+	result.voluntary_switches = end.voluntary_switches - m_start.voluntary_switches;
+	result.involuntary_switches = end.involuntary_switches - m_start.involuntary_switches;
+	result.minor_faults = end.minor_faults - m_start.minor_faults;
+	result.major_faults = end.major_faults - m_start.major_faults;
+	return result;
+}
@@ -0,0 +1,71 @@
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <map>
+
+#include "../advent/advent_input_store.h"
+
+namespace
+{
+	struct store
+	{
+		std::mutex lock;
+		std::map<std::string, std::shared_ptr<const std::string>, std::less<>> files;
+	};
+
+	store& get_store()
+	{
+		static store instance;
+		return instance;
+	}
+
+	thread_local std::shared_ptr<const std::string> puzzle_input_override;
+}
+
+bool advent::input_store::preload(const std::string& filename)
+{
+	if (find(filename) != nullptr)
+	{
+		return true;
+	}
+
+	// Text mode, like reading the file from disk with open_input, so a solution sees the same lines either way.
+	std::ifstream file{ filename };
+	if (!file.is_open())
+	{
+		return false;
+	}
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	auto data = std::make_shared<const std::string>(std::move(contents).str());
+
+	store& s = get_store();
+	std::scoped_lock guard{ s.lock };
+	s.files.try_emplace(filename, std::move(data));
+	return true;
+}
+
+std::shared_ptr<const std::string> advent::input_store::find(const std::string& filename)
+{
+	store& s = get_store();
+	std::scoped_lock guard{ s.lock };
+	const auto result = s.files.find(filename);
+	return result != end(s.files) ? result->second : nullptr;
+}
+
+void advent::input_store::clear()
+{
+	store& s = get_store();
+	std::scoped_lock guard{ s.lock };
+	s.files.clear();
+}
+
+void advent::input_store::set_puzzle_input_override(std::shared_ptr<const std::string> data)
+{
+	puzzle_input_override = std::move(data);
+}
+
+std::shared_ptr<const std::string> advent::input_store::get_puzzle_input_override()
+{
+	return puzzle_input_override;
+}
@@ -0,0 +1,244 @@
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+#include "../advent/advent_isolation.h"
+#include "../advent/advent_report.h"
+#include "../advent/advent_assert.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ADVENT_HAS_SPAWN 1
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <cerrno>
+extern char** environ;
+#else
+#define ADVENT_HAS_SPAWN 0
+#endif
+
+bool advent::process_isolation_supported() noexcept
+{
+	return ADVENT_HAS_SPAWN != 0;
+}
+
+#if ADVENT_HAS_SPAWN
+
+namespace
+{
+	// The child writes its result here. The parent puts the write end of a pipe on it when starting the child.
+	constexpr int RESULT_FD = 3;
+
+	void write_all(int fd, std::string_view data) noexcept
+	{
+		while (!data.empty())
+		{
+			const ssize_t written = write(fd, data.data(), data.size());
+			if (written < 0)
+			{
+				if (errno == EINTR) continue;
+				return;
+			}
+			data.remove_prefix(static_cast<std::size_t>(written));
+		}
+	}
+
+	// Close-on-exec, so children other threads start at the same time don't hold it open.
+	void make_result_pipe(int fds[2])
+	{
+#ifdef __linux__
+		AdventCheckMsg(pipe2(fds, O_CLOEXEC) == 0, "Could not create a pipe for an isolated test: ", std::strerror(errno));
+#else
+		AdventCheckMsg(pipe(fds) == 0, "Could not create a pipe for an isolated test: ", std::strerror(errno));
+		fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+		fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+		// dup2 onto itself wouldn't clear close-on-exec, so move it out of the way.
+		if (fds[1] == RESULT_FD)
+		{
+			const int moved = fcntl(fds[1], F_DUPFD_CLOEXEC, RESULT_FD + 1);
+			AdventCheckMsg(moved >= 0, "Could not create a pipe for an isolated test: ", std::strerror(errno));
+			close(fds[1]);
+			fds[1] = moved;
+		}
+	}
+
+	// Starts a new copy of this program with its stdin from /dev/null and the write end of the pipe as RESULT_FD.
+	pid_t spawn_child(const std::vector<std::string>& child_args, int write_fd)
+	{
+		std::vector<char*> argv;
+		argv.reserve(child_args.size() + 1);
+		for (const std::string& arg : child_args)
+		{
+			argv.push_back(const_cast<char*>(arg.c_str()));
+		}
+		argv.push_back(nullptr);
+
+		posix_spawn_file_actions_t actions;
+		posix_spawn_file_actions_init(&actions);
+		posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+		posix_spawn_file_actions_adddup2(&actions, write_fd, RESULT_FD);
+
+		pid_t child = -1;
+#ifdef __linux__
+		// argv[0] may be a relative path or a name found on PATH, so use what's actually running.
+		const int error = posix_spawn(&child, "/proc/self/exe", &actions, nullptr, argv.data(), environ);
+#else
+		const int error = posix_spawnp(&child, argv.front(), &actions, nullptr, argv.data(), environ);
+#endif
+		posix_spawn_file_actions_destroy(&actions);
+		AdventCheckMsg(error == 0, "Could not start an isolated test: ", std::strerror(error));
+		return child;
+	}
+
+	// Reads everything the child sends. Returns false if the deadline passes first.
+	bool read_until_eof(int read_fd, std::string& data, std::chrono::steady_clock::time_point deadline)
+	{
+		char buffer[4096];
+		while (true)
+		{
+			const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+			if (remaining.count() <= 0)
+			{
+				return false;
+			}
+			const int wait_ms = static_cast<int>(std::min<std::chrono::milliseconds::rep>(remaining.count(), 1'000'000));
+
+			pollfd pfd{ read_fd, POLLIN, 0 };
+			const int ready = poll(&pfd, 1, wait_ms);
+			if (ready < 0)
+			{
+				if (errno == EINTR) continue;
+				return true;
+			}
+			if (ready == 0)
+			{
+				continue;
+			}
+
+			const ssize_t num_read = read(read_fd, buffer, sizeof(buffer));
+			if (num_read < 0)
+			{
+				if (errno == EINTR) continue;
+				return true;
+			}
+			if (num_read == 0)
+			{
+				return true;
+			}
+			data.append(buffer, static_cast<std::size_t>(num_read));
+		}
+	}
+}
+
+void advent::report_to_isolating_parent(const test_result& result, const std::string& output)
+{
+	json::value message;
+	message.set("output", output);
+	message.set("result", to_json(result));
+	write_all(RESULT_FD, json::to_string(message));
+	close(RESULT_FD);
+}
+
+test_result advent::run_isolated(
+	const std::vector<std::string>& child_args,
+	std::string_view name,
+	const std::string& expected,
+	std::chrono::milliseconds timeout,
+	std::ostream& out)
+{
+	AdventCheck(!child_args.empty());
+	AdventCheck(timeout.count() > 0);
+	int fds[2];
+	make_result_pipe(fds);
+
+	// Anything buffered now could otherwise come out after the child's output.
+	std::cout.flush();
+	std::cerr.flush();
+
+	const auto start_time = std::chrono::steady_clock::now();
+	pid_t child = -1;
+	try
+	{
+		child = spawn_child(child_args, fds[1]);
+	}
+	catch (...)
+	{
+		close(fds[0]);
+		close(fds[1]);
+		throw;
+	}
+
+	close(fds[1]);
+	std::string message;
+	const bool finished = read_until_eof(fds[0], message, start_time + timeout);
+	close(fds[0]);
+	if (!finished)
+	{
+		kill(child, SIGKILL);
+	}
+
+	int wait_status = 0;
+	while (waitpid(child, &wait_status, 0) < 0 && errno == EINTR) {}
+	const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start_time;
+
+	auto failed_result = [&](test_status status, std::string description)
+	{
+		out << "Running test " << name << "... " << description << '\n';
+		test_result result;
+		result.name = std::string{ name };
+		result.expected = expected;
+		result.status = status;
+		result.result = std::move(description);
+		result.time_taken = elapsed;
+		return result;
+	};
+
+	if (!finished)
+	{
+		return failed_result(test_status::timed_out, "timed out after " + ::to_human_readable(elapsed));
+	}
+	if (WIFSIGNALED(wait_status))
+	{
+		const int sig = WTERMSIG(wait_status);
+		return failed_result(test_status::crashed, "crashed with signal " + std::to_string(sig) + " (" + strsignal(sig) + ')');
+	}
+	if (WIFEXITED(wait_status) && WEXITSTATUS(wait_status) != EXIT_SUCCESS)
+	{
+		return failed_result(test_status::exited, "exited with status " + std::to_string(WEXITSTATUS(wait_status)));
+	}
+
+	const auto parsed = json::parse(message);
+	const json::value* result_json = parsed.has_value() ? parsed->find("result") : nullptr;
+	const auto result = result_json != nullptr ? test_result_from_json(*result_json) : std::nullopt;
+	if (!result.has_value())
+	{
+		return failed_result(test_status::exited, "exited without reporting a result");
+	}
+	out << parsed->get_string("output");
+	return *result;
+}
+
+#else
+
+test_result advent::run_isolated(
+	const std::vector<std::string>&,
+	std::string_view,
+	const std::string&,
+	std::chrono::milliseconds,
+	std::ostream&)
+{
+	AdventCheckMsg(false, "Process isolation is not supported on this platform");
+	return test_result{};
+}
+
+void advent::report_to_isolating_parent(const test_result&, const std::string&)
+{
+}
+
+#endif
@@ -0,0 +1,391 @@
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <charconv>
+#include <cmath>
+#include <algorithm>
+
+#include "../advent/advent_json.h"
+#include "../advent/advent_assert.h"
+
+using namespace advent::json;
+
+bool value::as_bool() const
+{
+	AdventCheck(is_bool());
+	return std::get<bool>(m_data);
+}
+
+double value::as_number() const
+{
+	AdventCheck(is_number());
+	return std::get<double>(m_data);
+}
+
+int64_t value::as_int() const
+{
+	return static_cast<int64_t>(std::llround(as_number()));
+}
+
+const std::string& value::as_string() const
+{
+	AdventCheck(is_string());
+	return std::get<std::string>(m_data);
+}
+
+const array& value::as_array() const
+{
+	AdventCheck(is_array());
+	return std::get<array>(m_data);
+}
+
+array& value::as_array()
+{
+	AdventCheck(is_array());
+	return std::get<array>(m_data);
+}
+
+const object& value::as_object() const
+{
+	AdventCheck(is_object());
+	return std::get<object>(m_data);
+}
+
+object& value::as_object()
+{
+	AdventCheck(is_object());
+	return std::get<object>(m_data);
+}
+
+const value* value::find(std::string_view key) const noexcept
+{
+	if (!is_object()) return nullptr;
+	const object& obj = std::get<object>(m_data);
+	const auto result = std::ranges::find(obj, key, [](const auto& kvp) { return std::string_view{ kvp.first }; });
+	return result != end(obj) ? &result->second : nullptr;
+}
+
+void value::set(std::string_view key, value v)
+{
+	if (is_null())
+	{
+		m_data = object{};
+	}
+	object& obj = as_object();
+	const auto existing = std::ranges::find(obj, key, [](const auto& kvp) { return std::string_view{ kvp.first }; });
+	if (existing != end(obj))
+	{
+		existing->second = std::move(v);
+	}
+	else
+	{
+		obj.emplace_back(std::string{ key }, std::move(v));
+	}
+}
+
+double value::get_number(std::string_view key, double fallback) const noexcept
+{
+	const value* v = find(key);
+	return (v != nullptr && v->is_number()) ? v->as_number() : fallback;
+}
+
+int64_t value::get_int(std::string_view key, int64_t fallback) const noexcept
+{
+	const value* v = find(key);
+	return (v != nullptr && v->is_number()) ? v->as_int() : fallback;
+}
+
+std::string value::get_string(std::string_view key, std::string_view fallback) const
+{
+	const value* v = find(key);
+	return (v != nullptr && v->is_string()) ? v->as_string() : std::string{ fallback };
+}
+
+namespace
+{
+	void write_string(std::ostream& out, std::string_view str)
+	{
+		out << '"';
+		for (char c : str)
+		{
+			switch (c)
+			{
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\r': out << "\\r"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+				}
+				else
+				{
+					out << c;
+				}
+				break;
+			}
+		}
+		out << '"';
+	}
+
+	void write_number(std::ostream& out, double d)
+	{
+		if (!std::isfinite(d))
+		{
+			out << "null";
+			return;
+		}
+		// Print whole numbers (which is most of what we write, e.g. nanosecond counts) without an exponent.
+		if (d == std::floor(d) && std::abs(d) < 1e18)
+		{
+			out << static_cast<int64_t>(d);
+			return;
+		}
+		out << std::setprecision(17) << d;
+	}
+
+	struct writer
+	{
+		std::ostream& out;
+		int indent;
+
+		void newline(int depth)
+		{
+			if (indent > 0)
+			{
+				out << '\n' << std::string(static_cast<std::size_t>(indent * depth), ' ');
+			}
+		}
+
+		void write(const value& v, int depth)
+		{
+			if (v.is_null()) out << "null";
+			else if (v.is_bool()) out << (v.as_bool() ? "true" : "false");
+			else if (v.is_number()) write_number(out, v.as_number());
+			else if (v.is_string()) write_string(out, v.as_string());
+			else if (v.is_array())
+			{
+				const array& arr = v.as_array();
+				out << '[';
+				for (std::size_t i = 0; i < arr.size(); ++i)
+				{
+					if (i > 0) out << ',';
+					newline(depth + 1);
+					write(arr[i], depth + 1);
+				}
+				if (!arr.empty()) newline(depth);
+				out << ']';
+			}
+			else
+			{
+				const object& obj = v.as_object();
+				out << '{';
+				for (std::size_t i = 0; i < obj.size(); ++i)
+				{
+					if (i > 0) out << ',';
+					newline(depth + 1);
+					write_string(out, obj[i].first);
+					out << (indent > 0 ? ": " : ":");
+					write(obj[i].second, depth + 1);
+				}
+				if (!obj.empty()) newline(depth);
+				out << '}';
+			}
+		}
+	};
+
+	class parser
+	{
+		std::string_view m_text;
+		std::size_t m_pos = 0;
+
+		void skip_whitespace() noexcept
+		{
+			while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r' || m_text[m_pos] == '\t'))
+			{
+				++m_pos;
+			}
+		}
+
+		bool consume(char c) noexcept
+		{
+			skip_whitespace();
+			if (m_pos < m_text.size() && m_text[m_pos] == c)
+			{
+				++m_pos;
+				return true;
+			}
+			return false;
+		}
+
+		bool consume_word(std::string_view word) noexcept
+		{
+			if (m_text.substr(m_pos).starts_with(word))
+			{
+				m_pos += word.size();
+				return true;
+			}
+			return false;
+		}
+
+		std::optional<std::string> parse_string()
+		{
+			if (!consume('"')) return std::nullopt;
+			std::string result;
+			while (m_pos < m_text.size())
+			{
+				const char c = m_text[m_pos++];
+				if (c == '"') return result;
+				if (c != '\\')
+				{
+					result.push_back(c);
+					continue;
+				}
+				if (m_pos >= m_text.size()) return std::nullopt;
+				const char escaped = m_text[m_pos++];
+				switch (escaped)
+				{
+				case '"': result.push_back('"'); break;
+				case '\\': result.push_back('\\'); break;
+				case '/': result.push_back('/'); break;
+				case 'b': result.push_back('\b'); break;
+				case 'f': result.push_back('\f'); break;
+				case 'n': result.push_back('\n'); break;
+				case 'r': result.push_back('\r'); break;
+				case 't': result.push_back('\t'); break;
+				case 'u':
+				{
+					if (m_pos + 4 > m_text.size()) return std::nullopt;
+					unsigned int code = 0;
+					const auto [ptr, ec] = std::from_chars(m_text.data() + m_pos, m_text.data() + m_pos + 4, code, 16);
+					if (ec != std::errc{}) return std::nullopt;
+					m_pos += 4;
+					// We only ever write control characters this way, so anything outside ASCII is replaced.
+					result.push_back(code < 0x80 ? static_cast<char>(code) : '?');
+					break;
+				}
+				default:
+					return std::nullopt;
+				}
+			}
+			return std::nullopt;
+		}
+
+		std::optional<value> parse_number()
+		{
+			const std::size_t start = m_pos;
+			while (m_pos < m_text.size() && std::string_view{ "+-0123456789.eE" }.find(m_text[m_pos]) != std::string_view::npos)
+			{
+				++m_pos;
+			}
+			const std::string number_str{ m_text.substr(start, m_pos - start) };
+			if (number_str.empty()) return std::nullopt;
+			std::istringstream iss{ number_str };
+			double result = 0.0;
+			iss >> result;
+			if (iss.fail()) return std::nullopt;
+			return value{ result };
+		}
+	public:
+		explicit parser(std::string_view text) : m_text{ text } {}
+
+		std::optional<value> parse_value()
+		{
+			skip_whitespace();
+			if (m_pos >= m_text.size()) return std::nullopt;
+			switch (m_text[m_pos])
+			{
+			case 'n': return consume_word("null") ? std::optional<value>{ value{} } : std::nullopt;
+			case 't': return consume_word("true") ? std::optional<value>{ value{ true } } : std::nullopt;
+			case 'f': return consume_word("false") ? std::optional<value>{ value{ false } } : std::nullopt;
+			case '"':
+			{
+				auto str = parse_string();
+				return str.has_value() ? std::optional<value>{ value{ std::move(*str) } } : std::nullopt;
+			}
+			case '[':
+			{
+				++m_pos;
+				array result;
+				if (consume(']')) return value{ std::move(result) };
+				do
+				{
+					auto elem = parse_value();
+					if (!elem.has_value()) return std::nullopt;
+					result.push_back(std::move(*elem));
+				} while (consume(','));
+				if (!consume(']')) return std::nullopt;
+				return value{ std::move(result) };
+			}
+			case '{':
+			{
+				++m_pos;
+				object result;
+				if (consume('}')) return value{ std::move(result) };
+				do
+				{
+					skip_whitespace();
+					auto key = parse_string();
+					if (!key.has_value() || !consume(':')) return std::nullopt;
+					auto elem = parse_value();
+					if (!elem.has_value()) return std::nullopt;
+					result.emplace_back(std::move(*key), std::move(*elem));
+				} while (consume(','));
+				if (!consume('}')) return std::nullopt;
+				return value{ std::move(result) };
+			}
+			default:
+				return parse_number();
+			}
+		}
+
+		bool at_end() noexcept
+		{
+			skip_whitespace();
+			return m_pos == m_text.size();
+		}
+	};
+}
+
+std::string advent::json::to_string(const value& v, int indent)
+{
+	std::ostringstream oss;
+	writer{ oss, indent }.write(v, 0);
+	return oss.str();
+}
+
+std::optional<value> advent::json::parse(std::string_view text)
+{
+	parser p{ text };
+	auto result = p.parse_value();
+	if (!result.has_value() || !p.at_end())
+	{
+		return std::nullopt;
+	}
+	return result;
+}
+
+std::optional<value> advent::json::read_file(const std::string& filename)
+{
+	std::ifstream file{ filename, std::ios::binary };
+	if (!file.is_open())
+	{
+		return std::nullopt;
+	}
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	return parse(contents.str());
+}
+
+bool advent::json::write_file(const std::string& filename, const value& v)
+{
+	std::ofstream file{ filename, std::ios::binary };
+	if (!file.is_open())
+	{
+		return false;
+	}
+	file << to_string(v, 2) << '\n';
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,137 @@
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "../advent/advent_mapped_input.h"
+#include "../advent/advent_utils.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+	// Closes the descriptor when it goes out of scope. A mapping stays valid after its file is closed.
+	class file_descriptor
+	{
+		int m_fd;
+	public:
+		explicit file_descriptor(int fd) noexcept : m_fd{ fd } {}
+		~file_descriptor() { if (m_fd >= 0) close(m_fd); }
+		file_descriptor(const file_descriptor&) = delete;
+		file_descriptor& operator=(const file_descriptor&) = delete;
+		int get() const noexcept { return m_fd; }
+	};
+
+	// For anything that can't be mapped. Reads until end of file, so works for pipes of unknown length.
+	std::shared_ptr<const std::string> read_all(int fd)
+	{
+		std::string result;
+		constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+		while (true)
+		{
+			const std::size_t old_size = result.size();
+			result.resize(old_size + CHUNK_SIZE);
+			const ssize_t num_read = read(fd, result.data() + old_size, CHUNK_SIZE);
+			if (num_read <= 0)
+			{
+				result.resize(old_size);
+				AdventCheckMsg(num_read == 0, "Error reading input");
+				return std::make_shared<const std::string>(std::move(result));
+			}
+			result.resize(old_size + static_cast<std::size_t>(num_read));
+		}
+	}
+#endif
+}
+
+advent::mapped_input::mapped_input(std::shared_ptr<const std::string> data) noexcept
+	: m_buffer{ std::move(data) }
+{
+	if (m_buffer != nullptr)
+	{
+		m_view = *m_buffer;
+	}
+}
+
+advent::mapped_input::mapped_input(void* mapping, std::size_t size) noexcept
+	: m_view{ static_cast<const char*>(mapping), size }, m_mapping{ mapping }, m_mapping_size{ size }
+{
+}
+
+advent::mapped_input::~mapped_input()
+{
+#ifdef __linux__
+	if (m_mapping != nullptr)
+	{
+		munmap(m_mapping, m_mapping_size);
+	}
+#endif
+}
+
+advent::mapped_input::mapped_input(mapped_input&& other) noexcept
+	: m_view{ std::exchange(other.m_view, {}) }
+	, m_mapping{ std::exchange(other.m_mapping, nullptr) }
+	, m_mapping_size{ std::exchange(other.m_mapping_size, 0) }
+	, m_buffer{ std::move(other.m_buffer) }
+{
+}
+
+advent::mapped_input& advent::mapped_input::operator=(mapped_input&& other) noexcept
+{
+	if (this != &other)
+	{
+		mapped_input old{ std::move(*this) };
+		m_view = std::exchange(other.m_view, {});
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+		m_mapping_size = std::exchange(other.m_mapping_size, 0);
+		m_buffer = std::move(other.m_buffer);
+	}
+	return *this;
+}
+
+advent::mapped_input advent::map_input(const std::string& filename)
+{
+	if (auto preloaded = input_store::find(filename))
+	{
+		return mapped_input{ std::move(preloaded) };
+	}
+
+#ifdef __linux__
+	const file_descriptor fd{ open(filename.c_str(), O_RDONLY | O_CLOEXEC) };
+	AdventCheckMsg(fd.get() >= 0, "Could not open", filename);
+
+	struct stat info{};
+	const bool is_mappable = fstat(fd.get(), &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0;
+	if (is_mappable)
+	{
+		const auto size = static_cast<std::size_t>(info.st_size);
+		void* const mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+		if (mapping != MAP_FAILED)
+		{
+			madvise(mapping, size, MADV_SEQUENTIAL);
+			return mapped_input{ mapping, size };
+		}
+	}
+	return mapped_input{ read_all(fd.get()) };
+#else
+	std::ifstream file{ filename, std::ios::binary };
+	AdventCheckMsg(file.is_open(), "Could not open", filename);
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	return mapped_input{ std::make_shared<const std::string>(std::move(contents).str()) };
+#endif
+}
+
+advent::mapped_input advent::map_puzzle_input(int day)
+{
+	if (auto overridden = input_store::get_puzzle_input_override())
+	{
+		return mapped_input{ std::move(overridden) };
+	}
+	return map_input(puzzle_input_filename(day));
+}
@@ -9,11 +9,30 @@
 #include <iomanip>
 #include <cassert>
 #include <numeric>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <cctype>
+#include <thread>
+#include <cmath>
 
 #include "../advent/advent_of_code.h"
 #include "../advent/advent_headers.h"
 #include "../advent/advent_setup.h"
 #include "../advent/advent_assert.h"
+#include "../advent/advent_test_result.h"
+#include "../advent/advent_report.h"
+#include "../advent/advent_isolation.h"
+#include "../advent/advent_result_cache.h"
+#include "../advent/advent_trace.h"
+#include "../advent/advent_sampler.h"
+#include "../advent/advent_scaling.h"
+#include "../advent/advent_batch.h"
+#include "../advent/advent_stability.h"
+#include "../advent/advent_schedule.h"
+#include "../advent/advent_utils.h"
+#include "../utils/work_stealing_pool.h"
 
 namespace
 {
@@ -35,24 +54,39 @@ std::string to_string(const std::optional<std::string>& os)
 	return os.value_or("");
 }
 
-// Result a test can give.
-enum class test_status : char
+std::string_view to_string(test_status status) noexcept
 {
-	pass,
-	fail,
-	unknown,
-	filtered
-};
+	switch (status)
+	{
+	case test_status::pass:
+		return "pass";
+	case test_status::fail:
+		return "fail";
+	case test_status::filtered:
+		return "filtered";
+	case test_status::crashed:
+		return "crashed";
+	case test_status::timed_out:
+		return "timed_out";
+	case test_status::exited:
+		return "exited";
+	default:
+		return "unknown";
+	}
+}
 
-// Full results of a test.
-struct test_result
+std::optional<test_status> test_status_from_string(std::string_view str) noexcept
 {
-	std::string name;
-	std::string result;
-	std::string expected;
-	test_status status = test_status::unknown;
-	std::chrono::nanoseconds time_taken;
-};
+	for (test_status status : { test_status::pass, test_status::fail, test_status::unknown, test_status::filtered,
+		test_status::crashed, test_status::timed_out, test_status::exited })
+	{
+		if (to_string(status) == str)
+		{
+			return status;
+		}
+	}
+	return std::nullopt;
+}
 
 template <test_status status>
 bool check_result(const test_result& result)
@@ -60,6 +94,21 @@ bool check_result(const test_result& result)
 	return status == result.status;
 }
 
+// Crashes and timeouts count as failures too.
+bool is_failure(const test_result& result)
+{
+	switch (result.status)
+	{
+	case test_status::fail:
+	case test_status::crashed:
+	case test_status::timed_out:
+	case test_status::exited:
+		return true;
+	default:
+		return false;
+	}
+}
+
 std::string two_digits(int num)
 {
 	std::ostringstream oss;
@@ -170,87 +219,1177 @@ ResultType test_execute_wrapper(TestType test)
 #endif
 }
 
+// Stacks collected by the sampling profiler, in the folded format.
+struct sampled_stacks
+{
+	std::size_t num_samples = 0;
+	std::size_t num_dropped = 0;
+	std::string folded;
+};
+
+// Optional measurements taken around each timed run of a test, on top of the wall-clock time.
+// These are made per test so each one is tied to the thread running that test.
+class test_probes
+{
+	std::optional<advent::sampling_profiler> m_sampler;
+	std::optional<advent::perf_counters> m_perf_counters;
+	std::optional<advent::cpu_usage_meter> m_cpu_meter;
+	advent::cpu_usage m_cpu_totals;
+	std::optional<advent::profile_recorder> m_profile_recorder;
+	advent::phase_recorder m_phase_recorder;
+	advent::perf_counter_values m_counter_totals;
+	bool m_report_profile = false;
+	advent::allocation_stats m_allocation_totals;
+	std::size_t m_num_runs = 0;
+public:
+	explicit test_probes(const run_options& options)
+	{
+		if (options.perf_counters)
+		{
+			m_perf_counters.emplace();
+		}
+		if (options.measure_cpu && advent::is_cpu_usage_available())
+		{
+			m_cpu_meter.emplace();
+		}
+		if (!options.sample_dir.empty())
+		{
+			m_sampler.emplace(options.sample_frequency);
+		}
+		// Tracing needs the recorder too, so that profile scopes appear on the timeline.
+		if (options.profile || advent::trace::is_enabled())
+		{
+			m_profile_recorder.emplace();
+			m_report_profile = options.profile;
+		}
+	}
+
+	void start() noexcept
+	{
+		// Before allocation tracking, since the sampler may allocate when it starts.
+		if (m_sampler.has_value())
+		{
+			m_sampler->start();
+		}
+		if (advent::allocation_tracking_enabled())
+		{
+			advent::start_allocation_tracking();
+		}
+		if (m_perf_counters.has_value())
+		{
+			m_perf_counters->start();
+		}
+		m_phase_recorder.start();
+		if (m_profile_recorder.has_value())
+		{
+			m_profile_recorder->start();
+		}
+		// Last, so the other probes' setup isn't counted.
+		if (m_cpu_meter.has_value())
+		{
+			m_cpu_meter->start();
+		}
+	}
+
+	void stop() noexcept
+	{
+		if (m_cpu_meter.has_value())
+		{
+			m_cpu_totals += m_cpu_meter->stop();
+		}
+		if (m_profile_recorder.has_value())
+		{
+			m_profile_recorder->stop();
+		}
+		m_phase_recorder.stop();
+		if (m_perf_counters.has_value())
+		{
+			m_counter_totals += m_perf_counters->stop();
+		}
+		if (advent::allocation_tracking_enabled())
+		{
+			const advent::allocation_stats run_allocations = advent::stop_allocation_tracking();
+			m_allocation_totals.num_allocations += run_allocations.num_allocations;
+			m_allocation_totals.bytes_allocated += run_allocations.bytes_allocated;
+			m_allocation_totals.peak_live_bytes = std::max(m_allocation_totals.peak_live_bytes, run_allocations.peak_live_bytes);
+		}
+		if (m_sampler.has_value())
+		{
+			m_sampler->stop();
+		}
+		++m_num_runs;
+	}
+
+	// Averaged over all the timed runs.
+	advent::perf_counter_values get_counters() const noexcept
+	{
+		advent::perf_counter_values result = m_counter_totals;
+		result /= m_num_runs;
+		return result;
+	}
+
+	// Averaged over all the timed runs. Empty unless measuring CPU usage.
+	std::optional<advent::cpu_usage> get_cpu_usage() const noexcept
+	{
+		if (!m_cpu_meter.has_value() || m_num_runs == 0)
+		{
+			return std::nullopt;
+		}
+		advent::cpu_usage result = m_cpu_totals;
+		result /= m_num_runs;
+		return result;
+	}
+
+	// Averaged over all the timed runs.
+	std::vector<advent::phase_timing> get_phases() const
+	{
+		std::vector<advent::phase_timing> result = m_phase_recorder.get_phases();
+		for (advent::phase_timing& phase : result)
+		{
+			phase.time /= static_cast<std::chrono::nanoseconds::rep>(std::max(m_num_runs, std::size_t{ 1 }));
+		}
+		return result;
+	}
+
+	// Added up over all the timed runs. Empty unless sampling.
+	sampled_stacks get_sampled_stacks() const
+	{
+		if (!m_sampler.has_value())
+		{
+			return sampled_stacks{};
+		}
+		return sampled_stacks{ m_sampler->num_samples(), m_sampler->num_dropped(), m_sampler->get_folded_stacks() };
+	}
+
+	// Averaged over all the timed runs. Empty unless profiling.
+	std::vector<advent::profile_node> get_profile() const
+	{
+		return m_report_profile ? m_profile_recorder->get_tree() : std::vector<advent::profile_node>{};
+	}
+
+	// Counts and bytes are averaged over the timed runs, and the peak is the highest of any run.
+	std::optional<advent::allocation_stats> get_allocations() const noexcept
+	{
+		if (!advent::allocation_tracking_enabled() || m_num_runs == 0)
+		{
+			return std::nullopt;
+		}
+		advent::allocation_stats result = m_allocation_totals;
+		result.num_allocations /= m_num_runs;
+		result.bytes_allocated /= m_num_runs;
+		return result;
+	}
+};
+
 template <typename TestType>
-std::pair<ResultType,std::chrono::nanoseconds> run_test_func(TestType test)
+std::pair<ResultType,std::chrono::nanoseconds> run_test_func(TestType test, test_probes* probes = nullptr)
 {
+	if (probes != nullptr) probes->start();
 	const auto start_time = std::chrono::high_resolution_clock::now();
 	const ResultType res = test_execute_wrapper(std::move(test));
 	const auto end_time = std::chrono::high_resolution_clock::now();
+	if (probes != nullptr) probes->stop();
+	advent::trace::add_span(probes != nullptr ? "timed run" : "warmup run", "run", start_time, end_time);
 	return std::pair{res, end_time - start_time};
 }
 
+// Never auto-calibrate to more runs than this, however quick the test is.
+constexpr std::size_t MAX_CALIBRATED_REPETITIONS = 1'000'000;
+
+struct test_run
+{
+	ResultType result;
+	std::chrono::nanoseconds time_taken;
+	advent::timing_stats timing;
+	advent::perf_counter_values counters;
+	std::optional<advent::cpu_usage> cpu;
+	std::optional<advent::allocation_stats> allocations;
+	std::vector<advent::phase_timing> phases;
+	std::vector<advent::profile_node> profile;
+	sampled_stacks stacks;
+};
+
+// Runs a test once normally, or many times over in benchmark mode.
+// In benchmark mode the reported time is the median of the timed runs.
+template <typename TestType>
+test_run run_test_repeatedly(const TestType& test, const run_options& options)
+{
+	for (std::size_t i = 0; i < options.warmup_runs; ++i)
+	{
+		run_test_func(test);
+	}
+
+	test_probes probes{ options };
+	std::vector<std::chrono::nanoseconds> samples;
+	const auto [res, first_time] = run_test_func(test, &probes);
+	samples.push_back(first_time);
+
+	std::size_t num_repetitions = options.repetitions;
+	if (options.time_budget.count() > 0)
+	{
+		const auto per_run = std::max(first_time, std::chrono::nanoseconds{ 1 });
+		const auto calibrated = static_cast<std::size_t>(std::chrono::nanoseconds{ options.time_budget } / per_run);
+		num_repetitions = std::max(num_repetitions, std::clamp(calibrated, std::size_t{ 1 }, MAX_CALIBRATED_REPETITIONS));
+	}
+
+	samples.reserve(num_repetitions);
+	while (samples.size() < num_repetitions)
+	{
+		samples.push_back(run_test_func(test, &probes).second);
+	}
+
+	const advent::timing_stats timing = advent::calculate_timing_stats(std::move(samples));
+	return test_run{ res, timing.num_samples > 1 ? timing.median : first_time, timing, probes.get_counters(), probes.get_cpu_usage(), probes.get_allocations(), probes.get_phases(), probes.get_profile(), probes.get_sampled_stacks() };
+}
+
 struct TestExecutor
 {
+	const run_options& options;
 	template <typename TestType>
-	std::pair<ResultType,std::chrono::nanoseconds> operator()(TestType test) { return run_test_func(std::move(test)); }
+	test_run operator()(const TestType& test) { return run_test_repeatedly(test, options); }
 };
 
-test_result run_test(const verification_test& test, const std::vector<std::string_view>& filter)
+std::string to_human_readable(const advent::timing_stats& timing)
+{
+	std::ostringstream oss;
+	oss << "n=" << timing.num_samples
+		<< " min=" << to_human_readable(timing.min)
+		<< " median=" << to_human_readable(timing.median)
+		<< " mean=" << to_human_readable(timing.mean)
+		<< " p95=" << to_human_readable(timing.p95)
+		<< " stddev=" << to_human_readable(timing.stddev);
+	return oss.str();
+}
+
+// Works out the day from names like "advent_twelve_p1" or "advent_twelve_p2_testcase_a".
+std::optional<int> day_from_test_name(std::string_view name)
 {
-	if(!filter.empty())
+	constexpr std::array<std::string_view, 25> day_names{
+		"one", "two", "three", "four", "five", "six", "seven", "eight", "nine", "ten",
+		"eleven", "twelve", "thirteen", "fourteen", "fifteen", "sixteen", "seventeen", "eighteen", "nineteen", "twenty",
+		"twentyone", "twentytwo", "twentythree", "twentyfour", "twentyfive"
+	};
+	constexpr std::string_view prefix = "advent_";
+	if (!name.starts_with(prefix))
 	{
-		auto filter_pred = [name = std::string_view{ test.name }](std::string_view filter_item)
-		{
-			return name.find(filter_item) != name.npos;
-		};
-		const bool matches_filter = std::ranges::any_of(filter, filter_pred);
-		if(!matches_filter)
+		return std::nullopt;
+	}
+	name.remove_prefix(prefix.size());
+	const std::string_view day_name = name.substr(0, name.find('_'));
+	const auto found = std::ranges::find(day_names, day_name);
+	if (found == end(day_names))
+	{
+		return std::nullopt;
+	}
+	return static_cast<int>(std::distance(begin(day_names), found)) + 1;
+}
+
+// Loads the test's puzzle input into memory so reading it isn't part of the timed run.
+// Returns how long that took, or zero if there was nothing to load.
+std::chrono::nanoseconds preload_input(const verification_test& test)
+{
+	const auto day = day_from_test_name(test.name);
+	if (!day.has_value())
+	{
+		return std::chrono::nanoseconds{ 0 };
+	}
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	const bool loaded = advent::input_store::preload(advent::puzzle_input_filename(*day));
+	const auto end_time = std::chrono::high_resolution_clock::now();
+	advent::trace::add_span("load input", "load", start_time, end_time);
+	return loaded ? std::chrono::nanoseconds{ end_time - start_time } : std::chrono::nanoseconds{ 0 };
+}
+
+// Parses the input of a PARSED_DAY part, so that isn't part of the timed run either.
+// Empty if the test has no parse function, or the parse failed (in which case the test will hit the same error).
+std::optional<ParseTiming> parse_input(const verification_test& test)
+{
+	if (test.parse == nullptr)
+	{
+		return std::nullopt;
+	}
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	try
+	{
+		const ParseTiming result = test.parse();
+		advent::trace::add_span(result.reused ? "reuse parsed input" : "parse input", "parse", start_time, std::chrono::high_resolution_clock::now());
+		return result;
+	}
+	catch (const advent::test_failed&)
+	{
+		return std::nullopt;
+	}
+}
+
+std::string to_human_readable(std::chrono::nanoseconds input_load_time, const std::optional<ParseTiming>& input_parse, const std::vector<advent::phase_timing>& phases)
+{
+	std::ostringstream oss;
+	oss << "load=" << to_human_readable(input_load_time);
+	if (input_parse.has_value())
+	{
+		oss << " parse=" << to_human_readable(input_parse->time) << (input_parse->reused ? " (shared)" : "");
+	}
+	if (!phases.empty())
+	{
+		oss << " |";
+		for (const advent::phase_timing& phase : phases)
 		{
-			return test_result{
-				test.name,
-				"",
-				to_string(test.expected_result),
-				test_status::filtered
-			};
+			oss << ' ' << phase.name << '=' << to_human_readable(phase.time);
 		}
 	}
-	std::cout << "Running test " << test.name << "...";
-	const auto [res,time_taken] = std::visit(TestExecutor{}, test.test_func);
+	return oss.str();
+}
+
+bool passes_filter(const verification_test& test, const std::vector<std::string_view>& filter)
+{
+	if (filter.empty())
+	{
+		return true;
+	}
+	auto filter_pred = [name = std::string_view{ test.name }](std::string_view filter_item)
+	{
+		return name.find(filter_item) != name.npos;
+	};
+	return std::ranges::any_of(filter, filter_pred);
+}
+
+// Writes the stacks to "<dir>/<test name>.folded", ready for flamegraph.pl, inferno or speedscope.
+void write_sampled_stacks(std::string_view test_name, const sampled_stacks& stacks, const std::string& dir, std::ostream& out)
+{
+	if (stacks.num_samples == 0)
+	{
+		out << "    no stack samples (the test was too quick, or sampling isn't available)\n";
+		return;
+	}
+	std::string filename{ test_name };
+	std::ranges::replace_if(filename, [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-'; }, '_');
+	std::error_code ec;
+	std::filesystem::create_directories(dir, ec);
+	const std::filesystem::path path = std::filesystem::path{ dir } / (filename + ".folded");
+	std::ofstream file{ path };
+	file << stacks.folded;
+	if (!file)
+	{
+		out << "    could not write stack samples to " << path.string() << '\n';
+		return;
+	}
+	out << "    " << stacks.num_samples << " stack samples written to " << path.string();
+	if (stacks.num_dropped > 0)
+	{
+		out << " (" << stacks.num_dropped << " dropped)";
+	}
+	out << '\n';
+}
+
+test_result execute_test(const verification_test& test, const run_options& options, std::chrono::nanoseconds input_load_time, std::ostream& out)
+{
+	out << "Running test " << test.name << "...";
+	const std::optional<ParseTiming> input_parse = parse_input(test);
+	const auto [res,time_taken,timing,counters,cpu,allocations,phases,profile,stacks] = std::visit(TestExecutor{ options }, test.test_func);
 	const auto string_result = to_string(res);
-	std::cout << "\nFinished " << test.name << ": took " << to_human_readable(time_taken) <<  " and got " << string_result << '\n';
+	out << "\nFinished " << test.name << ": took " << to_human_readable(time_taken) <<  " and got " << string_result << '\n';
+	if (input_load_time.count() > 0 || input_parse.has_value() || !phases.empty())
+	{
+		out << "    " << to_human_readable(input_load_time, input_parse, phases) << '\n';
+	}
+	if (timing.num_samples > 1)
+	{
+		out << "    " << to_human_readable(timing) << '\n';
+	}
+	if (advent::is_noisy(timing, options.noise_threshold))
+	{
+		out << "    WARNING: noisy timing, runs varied by " << std::fixed << std::setprecision(1) << 100.0 * timing.relative_stddev() << "% of the mean\n";
+		out.unsetf(std::ios::floatfield);
+	}
+	if (!counters.empty())
+	{
+		out << "    " << advent::to_human_readable(counters) << '\n';
+	}
+	if (cpu.has_value())
+	{
+		out << "    " << advent::to_human_readable(*cpu) << '\n';
+	}
+	if (allocations.has_value())
+	{
+		out << "    " << advent::to_human_readable(*allocations) << '\n';
+	}
+	if (!profile.empty())
+	{
+		out << "    profile:\n" << advent::to_human_readable(profile);
+	}
+	if (!options.sample_dir.empty())
+	{
+		write_sampled_stacks(test.name, stacks, options.sample_dir, out);
+	}
 	auto get_result = [&](test_status status)
 	{
-		return test_result{ test.name,string_result,to_string(test.expected_result),status,time_taken };
+		test_result result;
+		result.name = test.name;
+		result.result = string_result;
+		result.expected = test.expected.to_string();
+		result.status = status;
+		result.time_taken = time_taken;
+		result.timing = timing;
+		result.counters = counters;
+		result.cpu = cpu;
+		result.allocations = allocations;
+		result.input_load_time = input_load_time;
+		result.input_parse = input_parse;
+		result.phases = phases;
+		result.profile = profile;
+		return result;
 	};
 
-	if(!test.expected_result.has_value())
+	if(!test.expected.has_value())
 	{
 		return get_result(test_status::unknown);
 	}
 	else
 	{
-		return get_result(string_result == *test.expected_result ? test_status::pass : test_status::fail);
+		return get_result(string_result == test.expected.to_string() ? test_status::pass : test_status::fail);
 	}
 }
 
+// Whether the run is about how long things take, rather than just checking the answers.
+bool is_measuring_timings(const run_options& options)
+{
+	return options.repetitions > 1 || options.time_budget.count() > 0 || !options.baseline_file.empty()
+		|| options.pin_cpu.has_value() || options.high_priority;
+}
+
+// Whether each test's run is wanted for what it measures, as well as its answer. A cached result would show
+// the measurements of whichever run stored it, so these runs never use one.
+bool is_measuring(const run_options& options)
+{
+	return is_measuring_timings(options) || options.warmup_runs > 0 || options.perf_counters || options.measure_cpu
+		|| options.profile || !options.sample_dir.empty();
+}
+
+// So a test that hangs can't stop an isolated run for good, even without --timeout.
+constexpr std::chrono::minutes DEFAULT_ISOLATION_TIMEOUT{ 10 };
+
+test_result run_test(const verification_test& test, const run_options& options, advent::result_cache* cache, std::ostream& out)
+{
+	if(!passes_filter(test, options.filters))
+	{
+		test_result result;
+		result.name = test.name;
+		result.expected = test.expected.to_string();
+		result.status = test_status::filtered;
+		return result;
+	}
+
+	const auto start_time = advent::trace::clock::now();
+	std::optional<uint64_t> cache_key;
+	if (cache != nullptr)
+	{
+		cache_key = cache->get_key(test.name, test.expected.to_string(), day_from_test_name(test.name));
+		if (cache_key.has_value() && !options.force && !is_measuring(options))
+		{
+			if (auto cached = cache->find(test.name, *cache_key))
+			{
+				out << "Running test " << test.name << "... unchanged, using cached result " << cached->result << '\n';
+				advent::trace::add_span(test.name, "cached test", start_time, advent::trace::clock::now());
+				return std::move(*cached);
+			}
+		}
+	}
+
+	test_result result = [&]()
+	{
+		if (options.isolate && advent::process_isolation_supported())
+		{
+			// The child is a new copy of this program, told to run just this test. See run_isolated_child.
+			std::vector<std::string> child_args;
+			child_args.push_back(options.program_path.empty() ? std::string{ "advent2024" } : options.program_path);
+			child_args.insert(end(child_args), begin(options.args), end(options.args));
+			child_args.push_back("--isolated-child");
+			child_args.push_back(std::string{ test.name });
+			const std::chrono::milliseconds timeout = options.timeout.count() > 0 ? options.timeout : DEFAULT_ISOLATION_TIMEOUT;
+			return advent::run_isolated(child_args, test.name, test.expected.to_string(), timeout, out);
+		}
+		const std::chrono::nanoseconds input_load_time = preload_input(test);
+		return execute_test(test, options, input_load_time, out);
+	}();
+
+	if (cache_key.has_value())
+	{
+		cache->store(result, *cache_key);
+	}
+	advent::trace::add_span(test.name, "test", start_time, advent::trace::clock::now());
+	return result;
+}
+
+// With --jobs, each worker gets its own CPU, counting up from --pin-cpu.
+void prepare_worker_thread(const run_options& options, std::size_t worker_idx)
+{
+	if (options.pin_cpu.has_value())
+	{
+		const std::size_t num_cpus = std::max(std::thread::hardware_concurrency(), 1u);
+		advent::pin_thread_to_cpu(static_cast<int>((static_cast<std::size_t>(*options.pin_cpu) + worker_idx) % num_cpus));
+	}
+	if (options.high_priority)
+	{
+		advent::raise_thread_priority();
+	}
+}
+
+// Applies --pin-cpu and --high-priority to the calling thread, and warns about anything likely to make timings noisy.
+// Returns a measure of the CPU speed to compare against at the end of the run.
+std::optional<std::chrono::nanoseconds> prepare_timing_environment(const run_options& options)
+{
+	if (options.pin_cpu.has_value() && options.num_jobs <= 1 && !advent::pin_thread_to_cpu(*options.pin_cpu))
+	{
+		std::cerr << "WARNING: could not pin to CPU " << *options.pin_cpu << ". It may not exist, or pinning isn't supported here.\n";
+	}
+	if (options.high_priority)
+	{
+		const std::optional<int> nice_value = advent::raise_thread_priority();
+		if (!nice_value.has_value())
+		{
+			std::cerr << "WARNING: could not raise the scheduling priority. This needs root, CAP_SYS_NICE or a raised RLIMIT_NICE.\n";
+		}
+		else if (*nice_value > -20)
+		{
+			std::cerr << "WARNING: only allowed to raise the scheduling priority to nice " << *nice_value << ".\n";
+		}
+	}
+	if (!is_measuring_timings(options))
+	{
+		return std::nullopt;
+	}
+	for (const std::string& source : advent::find_timing_noise_sources(options.pin_cpu))
+	{
+		std::cerr << "WARNING: " << source << '\n';
+	}
+	return advent::measure_cpu_speed();
+}
+
+// Warns if the CPU got faster or slower between the start and end of the run, e.g. from frequency scaling or throttling.
+void check_cpu_speed_drift(std::chrono::nanoseconds start_speed, double threshold)
+{
+	const std::chrono::nanoseconds end_speed = advent::measure_cpu_speed();
+	const double change = static_cast<double>(end_speed.count() - start_speed.count()) / static_cast<double>(std::max(start_speed.count(), int64_t{ 1 }));
+	if (std::abs(change) > threshold)
+	{
+		std::cerr << "WARNING: the CPU ran " << std::fixed << std::setprecision(1) << 100.0 * std::abs(change)
+			<< (change > 0.0 ? "% slower" : "% faster") << " at the end of the run than at the start, so timings may not be comparable.\n";
+		std::cerr.unsetf(std::ios::floatfield);
+	}
+}
+
+// The order to run the tests in with --jobs: longest first if there's a history, and the order of tests[] otherwise.
+// Prints the start of the schedule and puts the whole of it in the trace.
+std::vector<advent::scheduled_job> schedule_tests(const run_options& options, const advent::timing_history* history)
+{
+	// The tests to run, and where each is in tests[]. Jobs are scheduled by their index into these.
+	std::vector<std::string_view> names;
+	std::vector<std::size_t> test_indices;
+	for (std::size_t i = 0; i < std::size(tests); ++i)
+	{
+		if (passes_filter(tests[i], options.filters))
+		{
+			names.push_back(tests[i].name);
+			test_indices.push_back(i);
+		}
+	}
+	auto to_test_indices = [&test_indices](std::vector<advent::scheduled_job> jobs)
+	{
+		for (advent::scheduled_job& job : jobs)
+		{
+			job.index = test_indices[job.index];
+		}
+		return jobs;
+	};
+
+	if (history == nullptr)
+	{
+		std::vector<advent::scheduled_job> result;
+		for (std::size_t i = 0; i < names.size(); ++i)
+		{
+			result.push_back(advent::scheduled_job{ i });
+		}
+		return to_test_indices(std::move(result));
+	}
+
+	std::vector<advent::scheduled_job> result = advent::schedule_longest_first(names, *history);
+	advent::json::array schedule_json;
+	for (const advent::scheduled_job& job : result)
+	{
+		advent::json::value job_json;
+		job_json.set("name", names[job.index]);
+		job_json.set("estimate_ns", job.estimate.count());
+		job_json.set("from_history", job.from_history);
+		schedule_json.push_back(std::move(job_json));
+	}
+	advent::trace::set_metadata("schedule", std::move(schedule_json));
+
+	constexpr std::size_t NUM_TO_SHOW = 5;
+	if (std::ranges::none_of(result, &advent::scheduled_job::from_history))
+	{
+		std::cout << "No test times in " << options.history_file << " yet, so running the tests in order.\n";
+	}
+	else
+	{
+		std::cout << "Running the longest tests first:";
+		for (std::size_t i = 0; i < std::min(result.size(), NUM_TO_SHOW); ++i)
+		{
+			std::cout << (i > 0 ? ", " : " ") << names[result[i].index] << " (" << (result[i].from_history ? "" : "guessed ") << to_human_readable(result[i].estimate) << ')';
+		}
+		std::cout << (result.size() > NUM_TO_SHOW ? ", ...\n" : "\n");
+	}
+
+	return to_test_indices(std::move(result));
+}
+
+// Runs the tests on a work-stealing pool. Each test's console output is collected
+// and written in one go when it finishes so that tests don't interleave their output.
+// Jobs are queued in schedule order, and each worker starts on its own queue from the front,
+// so the first jobs in the schedule are the first to start.
+template <std::size_t NUM_TESTS>
+void run_tests_in_parallel(std::array<test_result, NUM_TESTS>& results, std::array<std::chrono::nanoseconds, NUM_TESTS>& job_times,
+	const run_options& options, advent::result_cache* cache, const advent::timing_history* history)
+{
+	for (std::size_t i = 0; i < NUM_TESTS; ++i)
+	{
+		if (!passes_filter(tests[i], options.filters))
+		{
+			results[i] = run_test(tests[i], options, cache, std::cout);
+		}
+	}
+
+	std::mutex output_lock;
+	utils::work_stealing_pool pool{ options.num_jobs };
+	for (const advent::scheduled_job& job : schedule_tests(options, history))
+	{
+		pool.push([i = job.index, &results, &job_times, &options, cache, &output_lock](std::size_t worker_idx)
+			{
+				advent::trace::set_thread_name("worker " + std::to_string(worker_idx));
+				prepare_worker_thread(options, worker_idx);
+				std::ostringstream out;
+				const auto start_time = std::chrono::high_resolution_clock::now();
+				results[i] = run_test(tests[i], options, cache, out);
+				job_times[i] = std::chrono::high_resolution_clock::now() - start_time;
+				std::scoped_lock guard{ output_lock };
+				std::cout << out.str() << std::flush;
+			});
+	}
+	pool.wait();
+}
+
+// Runs the day's puzzle solutions (not testcases) on one batch input file.
+advent::batch_file_result run_batch_file(int day, const std::filesystem::path& path, const run_options& options)
+{
+	advent::batch_file_result result;
+	result.day = day;
+	result.filename = path.string();
+
+	const auto load_start = std::chrono::high_resolution_clock::now();
+	// Text mode, as the solutions expect from open_puzzle_input.
+	std::ifstream file{ path };
+	if (!file.is_open())
+	{
+		result.read_error = true;
+		return result;
+	}
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	auto data = std::make_shared<const std::string>(std::move(contents).str());
+	result.load_time = std::chrono::high_resolution_clock::now() - load_start;
+	result.bytes = data->size();
+
+	advent::input_store::set_puzzle_input_override(std::move(data));
+	for (const verification_test& test : tests)
+	{
+		const bool is_solution = test.name.ends_with("_p1") || test.name.ends_with("_p2");
+		if (!is_solution || day_from_test_name(test.name) != day || !passes_filter(test, options.filters) || !std::holds_alternative<TestExecutable>(test.test_func))
+		{
+			continue;
+		}
+		const std::optional<ParseTiming> input_parse = parse_input(test);
+		if (input_parse.has_value() && !input_parse->reused)
+		{
+			result.parse_time += input_parse->time;
+		}
+		advent::batch_test_result test_result;
+		test_result.test_name = test.name;
+		const auto start_time = std::chrono::high_resolution_clock::now();
+		try
+		{
+			test_result.result = to_string(std::get<TestExecutable>(test.test_func).execute());
+		}
+		catch (const advent::test_failed& tf)
+		{
+			test_result.result = std::string{ tf.what() };
+			test_result.error = true;
+		}
+		const auto end_time = std::chrono::high_resolution_clock::now();
+		test_result.time = end_time - start_time;
+		advent::trace::add_span(test.name, "test", start_time, end_time);
+		result.tests.push_back(std::move(test_result));
+	}
+	advent::input_store::set_puzzle_input_override(nullptr);
+	return result;
+}
+
+// Batch mode: runs each day's solutions on the files named by --batch instead of the tests.
+bool run_batch(const run_options& options)
+{
+	struct batch_item
+	{
+		int day;
+		std::filesystem::path file;
+	};
+	std::vector<batch_item> items;
+	for (const run_options::batch_source& source : options.batch_sources)
+	{
+		const std::vector<std::filesystem::path> files = advent::expand_batch_path(source.path);
+		if (files.empty())
+		{
+			std::cerr << "WARNING: no input files found for --batch " << source.day << '=' << source.path << '\n';
+		}
+		std::ranges::transform(files, std::back_inserter(items), [&source](const std::filesystem::path& file)
+			{
+				return batch_item{ source.day, file };
+			});
+	}
+
+	std::vector<advent::batch_file_result> results(items.size());
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	if (options.num_jobs > 1)
+	{
+		utils::work_stealing_pool pool{ options.num_jobs };
+		for (std::size_t i = 0; i < items.size(); ++i)
+		{
+			pool.push([i, &items, &results, &options](std::size_t worker_idx)
+				{
+					advent::trace::set_thread_name("worker " + std::to_string(worker_idx));
+					prepare_worker_thread(options, worker_idx);
+					results[i] = run_batch_file(items[i].day, items[i].file, options);
+				});
+		}
+		pool.wait();
+	}
+	else
+	{
+		for (std::size_t i = 0; i < items.size(); ++i)
+		{
+			results[i] = run_batch_file(items[i].day, items[i].file, options);
+		}
+	}
+	const std::chrono::nanoseconds wall_time = std::chrono::high_resolution_clock::now() - start_time;
+
+	for (const advent::batch_file_result& result : results)
+	{
+		std::cout << advent::to_human_readable(result) << '\n';
+	}
+
+	const advent::batch_summary summary = advent::summarise_batch(results, wall_time);
+	std::cout << std::fixed << std::setprecision(1) <<
+		"BATCH:\n"
+		"    FILES  : " << summary.num_files << "\n"
+		"    ERRORS : " << summary.num_errors << "\n"
+		"    INPUT  : " << advent::bytes_to_human_readable(summary.total_bytes) << "\n"
+		"    SOLVE  : " << to_human_readable(summary.solve_time) << "\n"
+		"    WALL   : " << to_human_readable(summary.wall_time) << " (" << options.num_jobs << (options.num_jobs == 1 ? " job" : " jobs") << ")\n"
+		"    RATE   : " << summary.files_per_second() << " inputs/s, " << summary.megabytes_per_second() << " MB/s\n";
+	std::cout.unsetf(std::ios::floatfield);
+
+	if (!options.report_file.empty())
+	{
+		if (advent::write_batch_report(options.report_file, results, summary, options))
+		{
+			std::cout << "Wrote report to " << options.report_file << '\n';
+		}
+		else
+		{
+			std::cerr << "Could not write report to " << options.report_file << '\n';
+		}
+	}
+	return summary.num_errors == 0;
+}
+
+// The names variants run under, e.g. "advent_one_p1/simd", in the order of solver_variants[]. Each starts with
+// its part's name, so filters that pick the part pick it too. Made once and kept for the whole run, since the
+// trace holds on to the names of the tests it has seen until it's written.
+const std::vector<std::string>& variant_test_names()
+{
+	static const std::vector<std::string> names = []()
+	{
+		std::vector<std::string> result;
+		for (const solver_variant& variant : solver_variants)
+		{
+			result.push_back(std::string{ variant.reference_name } + '/' + std::string{ variant.name });
+		}
+		return result;
+	}();
+	return names;
+}
+
+// solver_variants[variant_idx] as a test, so it is run the same way as its part, including --isolate and --timeout.
+// It has no expected result, since it's checked against the result its part got.
+verification_test make_variant_test(std::size_t variant_idx)
+{
+	const solver_variant& variant = solver_variants[variant_idx];
+	const auto reference = std::ranges::find(tests, variant.reference_name, &verification_test::name);
+	const ParseFunc parse = reference != std::ranges::end(tests) ? reference->parse : nullptr;
+	return verification_test{ variant_test_names()[variant_idx], TestExecutable{ variant.func }, dummy, parse };
+}
+
+// Runs each variant in solver_variants[] whose part ran, and checks it gets the same result as the part.
+// Prints a table of each part followed by its variants, with their times and speedups. Returns false on any mismatch.
+template <std::size_t NUM_TESTS>
+bool run_variants(const std::array<test_result, NUM_TESTS>& results, const run_options& options)
+{
+	struct variant_row
+	{
+		std::string_view reference_name;
+		std::string_view name;
+		std::chrono::nanoseconds time{ 0 };
+		std::optional<double> speedup;	// Empty for the reference.
+		std::string status;
+	};
+
+	for (const solver_variant& variant : solver_variants)
+	{
+		if (std::ranges::find(tests, variant.reference_name, &verification_test::name) == std::ranges::end(tests))
+		{
+			std::cerr << "WARNING: variant " << variant.name << " is of " << variant.reference_name << ", which isn't in tests[]\n";
+		}
+	}
+
+	// Going through the parts in order keeps each part's rows together, wherever its variants are in solver_variants[].
+	std::vector<variant_row> rows;
+	std::size_t num_mismatches = 0;
+	for (std::size_t i = 0; i < NUM_TESTS; ++i)
+	{
+		const verification_test& reference = tests[i];
+		const test_result& reference_result = results[i];
+		// A part that crashed or timed out has no result to compare against. One that failed still does.
+		if (reference_result.status == test_status::filtered || (is_failure(reference_result) && reference_result.status != test_status::fail))
+		{
+			continue;
+		}
+		bool is_first_variant = true;
+		for (std::size_t variant_idx = 0; variant_idx < solver_variants.size(); ++variant_idx)
+		{
+			const solver_variant& variant = solver_variants[variant_idx];
+			if (variant.reference_name != reference.name)
+			{
+				continue;
+			}
+			if (is_first_variant)
+			{
+				rows.push_back(variant_row{ reference.name, "reference", reference_result.time_taken, std::nullopt, reference_result.result });
+				is_first_variant = false;
+			}
+
+			// Variants are only worth running for their timings, so they don't use the cache.
+			const test_result result = run_test(make_variant_test(variant_idx), options, nullptr, std::cout);
+
+			const double speedup = static_cast<double>(reference_result.time_taken.count()) / static_cast<double>(std::max(result.time_taken.count(), int64_t{ 1 }));
+			std::string status;
+			if (is_failure(result))
+			{
+				status = "MISMATCH (" + std::string{ to_string(result.status) } + ": " + result.result + ')';
+			}
+			else if (result.result != reference_result.result)
+			{
+				status = "MISMATCH (got " + result.result + ')';
+			}
+			else
+			{
+				status = "MATCH";
+			}
+			if (status != "MATCH")
+			{
+				++num_mismatches;
+			}
+			rows.push_back(variant_row{ reference.name, variant.name, result.time_taken, speedup, std::move(status) });
+		}
+	}
+
+	if (rows.empty())
+	{
+		return true;
+	}
+
+	auto width_of = [&rows](auto member)
+	{
+		return std::ranges::max(rows | std::views::transform([member](const variant_row& row) { return std::string_view{ row.*member }.size(); }));
+	};
+	const auto reference_width = static_cast<int>(width_of(&variant_row::reference_name)) + 2;
+	const auto name_width = static_cast<int>(width_of(&variant_row::name)) + 2;
+	std::cout << "VARIANTS:\n" << std::fixed << std::setprecision(2);
+	for (const variant_row& row : rows)
+	{
+		std::cout << "    " << std::left << std::setw(reference_width) << row.reference_name << std::setw(name_width) << row.name
+			<< std::right << std::setw(10) << to_human_readable(row.time);
+		if (row.speedup.has_value())
+		{
+			std::cout << std::setw(9) << *row.speedup << "x  " << row.status;
+		}
+		else
+		{
+			std::cout << "           got " << row.status;
+		}
+		std::cout << '\n';
+	}
+	std::cout.unsetf(std::ios::floatfield);
+	std::cout << "    MISMATCH: " << num_mismatches << '\n';
+	return num_mismatches == 0;
+}
+
+// Scaling mode: runs the solvers in scaling_tests[] instead of the tests.
+bool run_scaling_tests(const run_options& options)
+{
+	if (!advent::allocation_tracking_enabled())
+	{
+		std::cout << "Memory isn't measured. Configure with -DADVENT_TRACK_ALLOCATIONS=ON to see it.\n";
+	}
+
+	std::size_t num_run = 0;
+	std::size_t num_warnings = 0;
+	bool success = true;
+	for (const scaling_test& test : scaling_tests)
+	{
+		if (!options.filters.empty() && std::ranges::none_of(options.filters, [&test](std::string_view filter) { return test.name.find(filter) < test.name.size(); }))
+		{
+			continue;
+		}
+		std::cout << test.name << " scaling:\n";
+		const advent::scaling_result result = advent::run_scaling_test(test, options);
+		std::cout << advent::to_human_readable(result);
+		++num_run;
+		if (result.error.has_value())
+		{
+			success = false;
+		}
+		if (advent::has_superlinear_growth(result))
+		{
+			++num_warnings;
+		}
+	}
+
+	if (num_run == 0)
+	{
+		std::cout << "No scaling tests to run. Add them to scaling_tests[] in advent_setup.h with SCALING_TESTCASE.\n";
+	}
+	else
+	{
+		std::cout << "SCALING:\n"
+			"    RUN    : " << num_run << "\n"
+			"    WARNING: " << num_warnings << '\n';
+	}
+	return success;
+}
+
 bool verify_all(const std::vector<std::string_view>& filter)
 {
+	run_options options;
+	options.filters = filter;
+	return verify_all(options);
+}
+
+// In the child process run_isolated starts: runs the one test and sends the result back.
+bool run_isolated_child(const run_options& options)
+{
+	const std::string_view name = options.isolated_child_test;
+	std::optional<verification_test> test;
+	if (const auto found = std::ranges::find(tests, name, &verification_test::name); found != std::ranges::end(tests))
+	{
+		test = *found;
+	}
+	else if (const auto variant = std::ranges::find(variant_test_names(), name); variant != std::ranges::end(variant_test_names()))
+	{
+		test = make_variant_test(static_cast<std::size_t>(std::distance(std::ranges::begin(variant_test_names()), variant)));
+	}
+	if (!test.has_value())
+	{
+		std::cerr << "ERROR: no test named " << name << '\n';
+		return false;
+	}
+	std::ostringstream out;
+	const std::chrono::nanoseconds input_load_time = preload_input(*test);
+	const test_result result = execute_test(*test, options, input_load_time, out);
+	advent::report_to_isolating_parent(result, out.str());
+	return true;
+}
+
+bool verify_all(const run_options& options)
+{
+	if (!options.isolated_child_test.empty())
+	{
+		return run_isolated_child(options);
+	}
+	if (options.isolate && !advent::process_isolation_supported())
+	{
+		std::cerr << "WARNING: process isolation is not supported on this platform. Tests will run in-process without timeouts.\n";
+	}
+	if (!options.sample_dir.empty() && !advent::sampling_profiler{ options.sample_frequency }.is_available())
+	{
+		std::cerr << "WARNING: the sampling profiler is not available. It needs Linux.\n";
+	}
+	if (options.measure_cpu && !advent::is_cpu_usage_available())
+	{
+		std::cerr << "WARNING: CPU usage can only be measured on Linux.\n";
+	}
+	else if (options.measure_cpu && options.num_jobs > 1)
+	{
+		std::cerr << "WARNING: with --jobs, each test's process CPU time includes whatever the other tests were doing at the same time.\n";
+	}
+	if (advent::allocation_tracking_enabled() && options.num_jobs > 1)
+	{
+		std::cerr << "WARNING: with --jobs, each test's allocation counts include whatever the other tests allocated at the same time.\n";
+	}
+	if (options.perf_counters && !advent::perf_counters{}.is_available())
+	{
+		std::cerr << "WARNING: hardware performance counters are not available."
+			" On Linux, check /proc/sys/kernel/perf_event_paranoid.\n";
+	}
+
+	const std::optional<std::chrono::nanoseconds> start_cpu_speed = prepare_timing_environment(options);
+
+	if (options.scaling)
+	{
+		return run_scaling_tests(options);
+	}
+
+	if (!options.trace_file.empty())
+	{
+		advent::trace::enable();
+		advent::trace::set_thread_name("main");
+	}
+
+	if (!options.batch_sources.empty())
+	{
+		const bool batch_success = run_batch(options);
+		if (!options.trace_file.empty() && !advent::trace::write_file(options.trace_file))
+		{
+			std::cerr << "Could not write trace to " << options.trace_file << '\n';
+		}
+		return batch_success;
+	}
+
+	std::optional<advent::result_cache> cache;
+	if (!options.cache_file.empty())
+	{
+		cache.emplace(options.cache_file, options.program_path);
+	}
+	advent::result_cache* const cache_ptr = cache.has_value() ? &*cache : nullptr;
+
+	std::optional<advent::timing_history> history;
+	if (!options.history_file.empty())
+	{
+		history.emplace(options.history_file);
+	}
+	const advent::timing_history* const history_ptr = history.has_value() ? &*history : nullptr;
+	const auto num_to_run = std::ranges::count_if(tests, [&options](const verification_test& test) { return passes_filter(test, options.filters); });
+	const auto num_with_history = !history.has_value() ? 0 : std::ranges::count_if(tests, [&options, &history](const verification_test& test)
+		{
+			return passes_filter(test, options.filters) && history->find(test.name).has_value();
+		});
+
 	constexpr auto NUM_TESTS = std::size(tests);
 	std::array<test_result, NUM_TESTS> results;
-	std::ranges::transform(tests, begin(results),
-		[&filter](const verification_test& test)
+	std::array<std::chrono::nanoseconds, NUM_TESTS> job_times{};
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	if (options.num_jobs > 1)
+	{
+		run_tests_in_parallel(results, job_times, options, cache_ptr, history_ptr);
+	}
+	else
+	{
+		for (std::size_t i = 0; i < NUM_TESTS; ++i)
 		{
-			return run_test(test, filter);
-		});
+			const auto job_start_time = std::chrono::high_resolution_clock::now();
+			results[i] = run_test(tests[i], options, cache_ptr, std::cout);
+			job_times[i] = std::chrono::high_resolution_clock::now() - job_start_time;
+		}
+	}
+	// Before saving anything, so WALL is just the tests.
+	const std::chrono::nanoseconds wall_time = std::chrono::high_resolution_clock::now() - start_time;
+	if (cache.has_value() && !cache->save())
+	{
+		std::cerr << "Could not write the result cache to " << options.cache_file << '\n';
+	}
+	if (history.has_value())
+	{
+		// The whole job, including warmups, repeats and loading, since that's what the schedule has to fit.
+		// Cached results took no time this run, so they say nothing about how long running them would take.
+		for (std::size_t i = 0; i < NUM_TESTS; ++i)
+		{
+			if (results[i].status != test_status::filtered && !results[i].from_cache)
+			{
+				history->record(results[i].name, job_times[i]);
+			}
+		}
+		if (!history->save())
+		{
+			std::cerr << "Could not write the timing history to " << options.history_file << '\n';
+		}
+	}
+	if (start_cpu_speed.has_value())
+	{
+		check_cpu_speed_drift(*start_cpu_speed, options.noise_threshold);
+	}
 
-	auto result_to_string = [&filter](const test_result& result)
+	auto result_to_string = [&options](const test_result& result)
 	{
 		std::ostringstream oss;
 		oss << result.name << ": " << result.result << " - ";
 		switch (result.status)
 		{
 		case test_status::pass:
-			oss << "PASS\n";
+			oss << "PASS";
 			break;
 		case test_status::fail:
-			oss << "FAIL (expected " << result.expected << ")\n";
+			oss << "FAIL (expected " << result.expected << ")";
 			break;
 		case test_status::filtered:
 			return std::string{ "" };
+		case test_status::crashed:
+			oss << "CRASHED";
+			break;
+		case test_status::timed_out:
+			oss << "TIMED OUT";
+			break;
+		case test_status::exited:
+			oss << "EXITED";
+			break;
 		default: // unknown
-			oss << "[Unknown]\n";
+			oss << "[Unknown]";
 			break;
 		}
+		if (result.input_parse.has_value() || !result.phases.empty())
+		{
+			oss << " [" << to_human_readable(result.input_load_time, result.input_parse, result.phases) << ']';
+		}
+		if (result.timing.num_samples > 1)
+		{
+			oss << " [" << to_human_readable(result.timing) << ']';
+		}
+		if (!result.counters.empty())
+		{
+			oss << " [" << advent::to_human_readable(result.counters) << ']';
+		}
+		if (result.cpu.has_value())
+		{
+			oss << " [" << advent::to_human_readable(*result.cpu) << ']';
+		}
+		if (result.allocations.has_value())
+		{
+			oss << " [" << advent::to_human_readable(*result.allocations) << ']';
+		}
+		if (result.from_cache)
+		{
+			oss << " (cached)";
+		}
+		if (advent::is_noisy(result.timing, options.noise_threshold))
+		{
+			oss << " (noisy)";
+		}
+		oss << '\n';
 		return oss.str();
 	};
 
@@ -270,41 +1409,81 @@ bool verify_all(const std::vector<std::string_view>& filter)
 		"    FAILED : " << get_count(check_result<test_status::fail>) << "\n"
 		"    UNKNOWN: " << get_count(check_result<test_status::unknown>) << "\n"
 		"    TIME   : " << to_human_readable(total_time) << '\n';
-	return std::ranges::none_of(results,check_result<test_status::fail>);
-}
-
-verification_test make_test(std::string name, TestFunc func, int64_t result)
-{
-	return make_test(std::move(name), func, std::to_string(result));
-}
-
-verification_test make_test(std::string name, TestFunc func, std::string result)
-{
-	return verification_test{ std::move(name),func,std::move(result) };
-}
-
-verification_test make_test(std::string name, TestFunc func, Dummy)
-{
-	return verification_test{ std::move(name),func };
-}
-
-verification_test make_test(std::string name, TestFuncWithArg func, int64_t result, std::string arg)
-{
-	return make_test(std::move(name), func, std::to_string(result), std::move(arg));
-}
+	if (cache.has_value())
+	{
+		std::cout << "    CACHED : " << get_count([](const test_result& result) { return result.from_cache; }) << '\n';
+	}
+	if (options.isolate)
+	{
+		std::cout <<
+			"    CRASHED: " << get_count(check_result<test_status::crashed>) << "\n"
+			"    TIMEOUT: " << get_count(check_result<test_status::timed_out>) << "\n"
+			"    EXITED : " << get_count(check_result<test_status::exited>) << "\n";
+	}
+	if (is_measuring_timings(options))
+	{
+		std::cout << "    NOISY  : " << get_count([&options](const test_result& result) { return advent::is_noisy(result.timing, options.noise_threshold); }) << '\n';
+	}
+	if (options.num_jobs > 1)
+	{
+		std::cout << "    WALL   : " << to_human_readable(wall_time) << " (" << options.num_jobs << " jobs)\n";
+		if (history.has_value())
+		{
+			// No schedule can finish before its longest test does, so the closer WALL is to this the better.
+			const auto longest = std::ranges::max_element(job_times);
+			std::cout << "    ORDER  : longest first, " << num_with_history << " of " << num_to_run << " tests timed before\n"
+				"    LONGEST: " << to_human_readable(*longest) << " (" << tests[static_cast<std::size_t>(std::distance(begin(job_times), longest))].name << ")\n";
+		}
+	}
 
-verification_test make_test(std::string name, TestFuncWithArg func, std::string result, std::string arg)
-{
-	return verification_test{std::move(name), func, std::move(arg), std::move(result)};
+	bool success = std::ranges::none_of(results,is_failure);
+	success = run_variants(results, options) && success;
+	if (!options.trace_file.empty())
+	{
+		if (advent::trace::write_file(options.trace_file))
+		{
+			std::cout << "Wrote trace to " << options.trace_file << '\n';
+		}
+		else
+		{
+			std::cerr << "Could not write trace to " << options.trace_file << '\n';
+		}
+	}
+	if (!options.report_file.empty())
+	{
+		if (advent::write_report(options.report_file, results, options))
+		{
+			std::cout << "Wrote report to " << options.report_file << '\n';
+		}
+		else
+		{
+			std::cerr << "Could not write report to " << options.report_file << '\n';
+		}
+	}
+	if (!options.baseline_file.empty())
+	{
+		success = advent::check_against_baseline(options.baseline_file, results, options.regression_threshold, std::cout) && success;
+	}
+	return success;
 }
 
-verification_test make_test(std::string name, TestFuncWithArg func, Dummy, std::string arg)
+std::string expected_result::to_string() const
 {
-	return verification_test{std::move(name), func, std::move(arg)};
+	switch (m_kind)
+	{
+	case kind::signed_number:
+		return std::to_string(static_cast<int64_t>(m_number));
+	case kind::unsigned_number:
+		return std::to_string(m_number);
+	case kind::text:
+		return std::string{ m_text };
+	default:
+		return "";
+	}
 }
 
-ResultType TestWithArgExecutable::execute()
+ResultType TestWithArgExecutable::execute() const
 {
-	std::istringstream iss{ std::move(arg)};
+	std::istringstream iss{ arg() };
 	return func(iss);
 }
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "../advent/advent_of_code.h"
+
+namespace
+{
+	[[noreturn]] void options_error(std::string_view message)
+	{
+		std::cerr << "Error: " << message << "\n"
+			"Usage: advent2024 [options] [filters...]\n"
+			"Options:\n"
+			"    --jobs N           Run N tests at once. 0 uses one per hardware thread.\n"
+			"    --history FILE     Keep test times in FILE and run the longest tests first with --jobs.\n"
+			"    --warmup N         Run each test N times untimed before timing it.\n"
+			"    --repeat N         Time each test N times and report statistics.\n"
+			"    --time-budget MS   Time each test as many times as fits in MS milliseconds.\n"
+			"    --pin-cpu N        Pin the thread running tests to CPU N. With --jobs, worker i uses CPU N+i (Linux only).\n"
+			"    --high-priority    Run tests at the highest scheduling priority allowed (Linux only).\n"
+			"    --noise-threshold PCT  Flag tests whose repeated runs vary by more than PCT percent. Default 5.\n"
+			"    --perf             Collect hardware performance counters for each test (Linux only).\n"
+			"    --cpu              Show each test's CPU time, parallelism, context switches and page faults (Linux only).\n"
+			"    --profile          Print the tree of profile scopes each test went through.\n"
+			"    --isolate          Run each test in a child process so crashes and hangs don't stop the run. Tests are killed after 10 minutes.\n"
+			"    --timeout SECONDS  Kill any test that runs longer than this. Implies --isolate.\n"
+			"    --cache FILE       Skip tests whose code and input haven't changed since they were stored in FILE.\n"
+			"    --force            Run every test even if it has a cached result.\n"
+			"    --sample DIR       Sample each test's stack and write DIR/<test>.folded for flame graphs (Linux only).\n"
+			"    --sample-hz N      Samples per second of CPU for --sample. Default 997.\n"
+			"    --scale            Run the scaling tests on ever larger inputs and fit how time and memory grow.\n"
+			"    --scales LIST      Comma-separated input sizes for --scale. Default 1,10,100,1000.\n"
+			"    --scale-limit S    Skip scales predicted to take longer than S seconds. Default 10.\n"
+			"    --batch DAY=PATH   Run day DAY's solutions on every input in PATH: a directory, file or pattern like dir/*.txt.\n"
+			"    --trace FILE       Write a timeline of the run to FILE for Perfetto or chrome://tracing.\n"
+			"    --report FILE      Write the results to FILE as JSON, or CSV if FILE ends in .csv.\n"
+			"    --baseline FILE    Fail if any test is slower than in the JSON report FILE.\n"
+			"    --threshold PCT    How much slower than the baseline counts as a regression. Default 10.\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::size_t to_size(std::string_view option, std::string_view value)
+	{
+		std::size_t result = 0;
+		const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+		if (ec != std::errc{} || ptr != value.data() + value.size())
+		{
+			options_error(std::string{ option } + " expects a number but got '" + std::string{ value } + '\'');
+		}
+		return result;
+	}
+
+	class arg_reader
+	{
+		int m_argc;
+		char** m_argv;
+		int m_idx = 1;
+	public:
+		arg_reader(int argc, char** argv) : m_argc{ argc }, m_argv{ argv } {}
+		bool done() const noexcept { return m_idx >= m_argc; }
+		std::string_view next() noexcept { return m_argv[m_idx++]; }
+
+		// Supports both "--option value" and "--option=value".
+		std::string_view value_for(std::string_view& option)
+		{
+			const auto equals = option.find('=');
+			if (equals < option.size())
+			{
+				const std::string_view value = option.substr(equals + 1);
+				option = option.substr(0, equals);
+				return value;
+			}
+			if (done())
+			{
+				options_error(std::string{ option } + " expects a value");
+			}
+			return next();
+		}
+	};
+
+	// Every option taking a number wants a finite one that isn't negative. In particular "nan" would compare
+	// false with everything, quietly turning off whatever check the option sets a threshold for.
+	double to_double(std::string_view option, std::string_view value)
+	{
+		double result = 0.0;
+		const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+		if (ec != std::errc{} || ptr != value.data() + value.size() || !std::isfinite(result) || result < 0.0)
+		{
+			options_error(std::string{ option } + " expects a number that isn't negative but got '" + std::string{ value } + '\'');
+		}
+		return result;
+	}
+
+	// A number of seconds, which may have a fraction.
+	std::chrono::milliseconds seconds_to_milliseconds(std::string_view option, std::string_view value)
+	{
+		const double milliseconds = to_double(option, value) * 1000.0;
+		if (milliseconds >= static_cast<double>(std::numeric_limits<std::chrono::milliseconds::rep>::max()))
+		{
+			options_error(std::string{ option } + " is too long: '" + std::string{ value } + '\'');
+		}
+		return std::chrono::milliseconds{ static_cast<std::chrono::milliseconds::rep>(milliseconds) };
+	}
+
+	// E.g. "1,10,100". Every entry must be a positive number.
+	std::vector<std::size_t> to_size_list(std::string_view option, std::string_view value)
+	{
+		std::vector<std::size_t> result;
+		while (true)
+		{
+			const auto comma = value.find(',');
+			const std::size_t entry = to_size(option, value.substr(0, comma));
+			if (entry == 0)
+			{
+				options_error(std::string{ option } + " sizes must be above zero");
+			}
+			result.push_back(entry);
+			if (comma >= value.size())
+			{
+				return result;
+			}
+			value.remove_prefix(comma + 1);
+		}
+	}
+
+	std::string_view option_name(std::string_view arg)
+	{
+		return arg.substr(0, arg.find('='));
+	}
+
+	// For options that are either there or not. "--force=no" is an error rather than turning --force on.
+	bool flag(std::string_view arg)
+	{
+		if (arg.find('=') < arg.size())
+		{
+			options_error(std::string{ option_name(arg) } + " doesn't take a value but got '" + std::string{ arg } + '\'');
+		}
+		return true;
+	}
+}
+
+run_options parse_run_options(int argc, char** argv)
+{
+	run_options result;
+	if (argc > 0)
+	{
+		result.program_path = argv[0];
+		result.args.assign(argv + 1, argv + argc);
+	}
+	arg_reader args{ argc, argv };
+	while (!args.done())
+	{
+		std::string_view arg = args.next();
+		if (!arg.starts_with("--"))
+		{
+			result.filters.push_back(arg);
+			continue;
+		}
+
+		const std::string_view name = option_name(arg);
+		if (name == "--jobs")
+		{
+			result.num_jobs = to_size(name, args.value_for(arg));
+			if (result.num_jobs == 0)
+			{
+				result.num_jobs = std::max(std::thread::hardware_concurrency(), 1u);
+			}
+		}
+		else if (name == "--history")
+		{
+			result.history_file = args.value_for(arg);
+		}
+		else if (name == "--warmup")
+		{
+			result.warmup_runs = to_size(name, args.value_for(arg));
+		}
+		else if (name == "--repeat")
+		{
+			result.repetitions = std::max(to_size(name, args.value_for(arg)), std::size_t{ 1 });
+		}
+		else if (name == "--time-budget")
+		{
+			result.time_budget = std::chrono::milliseconds{ to_size(name, args.value_for(arg)) };
+		}
+		else if (name == "--pin-cpu")
+		{
+			result.pin_cpu = static_cast<int>(to_size(name, args.value_for(arg)));
+		}
+		else if (name == "--high-priority")
+		{
+			result.high_priority = flag(arg);
+		}
+		else if (name == "--noise-threshold")
+		{
+			result.noise_threshold = to_double(name, args.value_for(arg)) / 100.0;
+		}
+		else if (name == "--perf")
+		{
+			result.perf_counters = flag(arg);
+		}
+		else if (name == "--cpu")
+		{
+			result.measure_cpu = flag(arg);
+		}
+		else if (name == "--profile")
+		{
+			result.profile = flag(arg);
+		}
+		else if (name == "--isolate")
+		{
+			result.isolate = flag(arg);
+		}
+		else if (name == "--timeout")
+		{
+			result.timeout = seconds_to_milliseconds(name, args.value_for(arg));
+			result.isolate = true;
+		}
+		else if (name == "--isolated-child")
+		{
+			// Not for users: added to the command line of the child process run_isolated starts.
+			result.isolated_child_test = args.value_for(arg);
+		}
+		else if (name == "--cache")
+		{
+			result.cache_file = args.value_for(arg);
+		}
+		else if (name == "--force")
+		{
+			result.force = flag(arg);
+		}
+		else if (name == "--sample")
+		{
+			result.sample_dir = args.value_for(arg);
+		}
+		else if (name == "--sample-hz")
+		{
+			result.sample_frequency = static_cast<int>(std::clamp(to_size(name, args.value_for(arg)), std::size_t{ 1 }, std::size_t{ 100'000 }));
+		}
+		else if (name == "--scale")
+		{
+			result.scaling = flag(arg);
+		}
+		else if (name == "--scales")
+		{
+			result.scales = to_size_list(name, args.value_for(arg));
+			result.scaling = true;
+		}
+		else if (name == "--scale-limit")
+		{
+			result.scaling_time_limit = seconds_to_milliseconds(name, args.value_for(arg));
+		}
+		else if (name == "--batch")
+		{
+			const std::string_view value = args.value_for(arg);
+			const auto equals = value.find('=');
+			if (equals >= value.size())
+			{
+				options_error("--batch expects DAY=PATH but got '" + std::string{ value } + '\'');
+			}
+			const std::size_t day = to_size(name, value.substr(0, equals));
+			if (day < 1 || day > 25)
+			{
+				options_error("--batch day must be from 1 to 25");
+			}
+			result.batch_sources.push_back(run_options::batch_source{ static_cast<int>(day), std::string{ value.substr(equals + 1) } });
+		}
+		else if (name == "--trace")
+		{
+			result.trace_file = args.value_for(arg);
+		}
+		else if (name == "--report")
+		{
+			result.report_file = args.value_for(arg);
+		}
+		else if (name == "--baseline")
+		{
+			result.baseline_file = args.value_for(arg);
+		}
+		else if (name == "--threshold")
+		{
+			result.regression_threshold = to_double(name, args.value_for(arg)) / 100.0;
+		}
+		else
+		{
+			options_error("unrecognised option '" + std::string{ arg } + '\'');
+		}
+	}
+	return result;
+}
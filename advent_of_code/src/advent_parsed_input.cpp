@@ -0,0 +1,73 @@
+#include <mutex>
+#include <map>
+#include <utility>
+
+#include "../advent/advent_parsed_input.h"
+
+namespace
+{
+	using advent::parsed_input_cache::parse_id;
+
+	struct entry
+	{
+		// Held while parsing, so anyone else after the same entry waits for the result.
+		std::mutex lock;
+		std::weak_ptr<const std::string> data;
+		std::shared_ptr<const void> parsed;
+		std::chrono::nanoseconds parse_time{ 0 };
+	};
+
+	struct cache
+	{
+		std::mutex lock;
+		std::map<std::pair<parse_id, const std::string*>, std::shared_ptr<entry>> entries;
+	};
+
+	cache& get_cache()
+	{
+		static cache instance;
+		return instance;
+	}
+
+	std::shared_ptr<entry> find_or_add_entry(parse_id parse, const std::shared_ptr<const std::string>& data)
+	{
+		cache& c = get_cache();
+		std::scoped_lock guard{ c.lock };
+
+		// Forget parses of data nobody holds any more (e.g. earlier files in batch mode), which also means an
+		// address reused for new data can't find a stale entry.
+		std::erase_if(c.entries, [](const auto& key_and_entry) { return key_and_entry.second->data.expired(); });
+
+		std::shared_ptr<entry>& result = c.entries[std::pair{ parse, data.get() }];
+		if (result == nullptr)
+		{
+			result = std::make_shared<entry>();
+			result->data = data;
+		}
+		return result;
+	}
+}
+
+advent::parsed_input_cache::entry_view advent::parsed_input_cache::get(parse_id parse, const std::shared_ptr<const std::string>& data, parse_thunk thunk)
+{
+	const std::shared_ptr<entry> e = find_or_add_entry(parse, data);
+	std::scoped_lock guard{ e->lock };
+	if (e->parsed != nullptr)
+	{
+		return entry_view{ e->parsed, ParseTiming{ e->parse_time, true } };
+	}
+
+	memory_streambuf buffer{ data->data(), data->size() };
+	std::istream input{ &buffer };
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	e->parsed = thunk(input, parse);
+	e->parse_time = std::chrono::high_resolution_clock::now() - start_time;
+	return entry_view{ e->parsed, ParseTiming{ e->parse_time, false } };
+}
+
+void advent::parsed_input_cache::clear()
+{
+	cache& c = get_cache();
+	std::scoped_lock guard{ c.lock };
+	c.entries.clear();
+}
@@ -0,0 +1,184 @@
+#include <sstream>
+#include <algorithm>
+#include <iomanip>
+
+#include "../advent/advent_perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using advent::perf_counter_values;
+
+namespace
+{
+	// The order here matches perf_counters::m_fds.
+	constexpr std::array counter_members{
+		&perf_counter_values::cycles,
+		&perf_counter_values::instructions,
+		&perf_counter_values::l1d_read_misses,
+		&perf_counter_values::llc_misses,
+		&perf_counter_values::branch_misses
+	};
+
+#ifdef __linux__
+	struct counter_config
+	{
+		uint32_t type;
+		uint64_t config;
+	};
+
+	constexpr std::array<counter_config, counter_members.size()> counter_configs{ {
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+	} };
+
+	int open_counter(const counter_config& config) noexcept
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = config.type;
+		attr.config = config.config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		// pid = 0 and cpu = -1 counts this thread on whichever CPU it runs.
+		return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+	std::optional<uint64_t> read_counter(int fd) noexcept
+	{
+		struct
+		{
+			uint64_t value;
+			uint64_t time_enabled;
+			uint64_t time_running;
+		} data{};
+		if (read(fd, &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data.time_running == 0)
+		{
+			return std::nullopt;
+		}
+		if (data.time_running == data.time_enabled)
+		{
+			return data.value;
+		}
+		const double scale = static_cast<double>(data.time_enabled) / static_cast<double>(data.time_running);
+		return static_cast<uint64_t>(static_cast<double>(data.value) * scale);
+	}
+#endif
+}
+
+std::optional<double> perf_counter_values::instructions_per_cycle() const noexcept
+{
+	if (!cycles.has_value() || !instructions.has_value() || *cycles == 0)
+	{
+		return std::nullopt;
+	}
+	return static_cast<double>(*instructions) / static_cast<double>(*cycles);
+}
+
+perf_counter_values& perf_counter_values::operator+=(const perf_counter_values& other) noexcept
+{
+	for (auto member : counter_members)
+	{
+		if (!(other.*member).has_value()) continue;
+		this->*member = (this->*member).value_or(0) + *(other.*member);
+	}
+	return *this;
+}
+
+perf_counter_values& perf_counter_values::operator/=(uint64_t divisor) noexcept
+{
+	for (auto member : counter_members)
+	{
+		if ((this->*member).has_value() && divisor > 0)
+		{
+			*(this->*member) /= divisor;
+		}
+	}
+	return *this;
+}
+
+std::string advent::to_human_readable(const perf_counter_values& values)
+{
+	std::ostringstream oss;
+	auto add = [&oss](std::string_view name, const std::optional<uint64_t>& value)
+	{
+		if (!value.has_value()) return;
+		if (oss.tellp() > 0) oss << ' ';
+		oss << name << '=' << *value;
+	};
+	add("cycles", values.cycles);
+	add("instructions", values.instructions);
+	if (const auto ipc = values.instructions_per_cycle())
+	{
+		oss << " IPC=" << std::fixed << std::setprecision(2) << *ipc << std::defaultfloat;
+	}
+	add("L1D-misses", values.l1d_read_misses);
+	add("LLC-misses", values.llc_misses);
+	add("branch-misses", values.branch_misses);
+	return oss.str();
+}
+
+advent::perf_counters::perf_counters()
+{
+	m_fds.fill(-1);
+#ifdef __linux__
+	std::ranges::transform(counter_configs, begin(m_fds), open_counter);
+#endif
+}
+
+advent::perf_counters::~perf_counters()
+{
+#ifdef __linux__
+	for (int fd : m_fds)
+	{
+		if (fd >= 0) close(fd);
+	}
+#endif
+}
+
+bool advent::perf_counters::is_available() const noexcept
+{
+	return std::ranges::any_of(m_fds, [](int fd) { return fd >= 0; });
+}
+
+void advent::perf_counters::start() noexcept
+{
+#ifdef __linux__
+	for (int fd : m_fds)
+	{
+		if (fd < 0) continue;
+		ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+#endif
+}
+
+perf_counter_values advent::perf_counters::stop() noexcept
+{
+	perf_counter_values result;
+#ifdef __linux__
+	for (int fd : m_fds)
+	{
+		if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+	}
+	for (std::size_t i = 0; i < m_fds.size(); ++i)
+	{
+		if (m_fds[i] >= 0)
+		{
+			result.*counter_members[i] = read_counter(m_fds[i]);
+		}
+	}
+#endif
+	return result;
+}
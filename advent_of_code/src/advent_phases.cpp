@@ -0,0 +1,78 @@
+#include <algorithm>
+
+#include "../advent/advent_phases.h"
+#include "../advent/advent_trace.h"
+
+namespace
+{
+	constexpr std::string_view UNPHASED = "unphased";
+	thread_local advent::phase_recorder* active_recorder = nullptr;
+}
+
+void advent::phase_recorder::add_time(std::string_view name, std::chrono::nanoseconds time)
+{
+	const auto existing = std::ranges::find(m_phases, name, &raw_phase::name);
+	if (existing != end(m_phases))
+	{
+		existing->time += time;
+	}
+	else
+	{
+		m_phases.push_back(raw_phase{ name, time });
+	}
+}
+
+void advent::begin_phase(std::string_view name) noexcept
+{
+	phase_recorder* recorder = active_recorder;
+	if (recorder == nullptr)
+	{
+		return;
+	}
+	const auto now = std::chrono::high_resolution_clock::now();
+	recorder->add_time(recorder->m_current_phase, now - recorder->m_phase_start);
+	if (recorder->m_current_phase != UNPHASED)
+	{
+		advent::trace::add_span(recorder->m_current_phase, "phase", recorder->m_phase_start, now);
+	}
+	recorder->m_current_phase = name;
+	recorder->m_phase_start = now;
+	recorder->m_any_phases = true;
+}
+
+void advent::phase_recorder::start() noexcept
+{
+	// Avoid allocating while the test is running in the common case.
+	m_phases.reserve(8);
+	m_current_phase = UNPHASED;
+	active_recorder = this;
+	m_phase_start = std::chrono::high_resolution_clock::now();
+}
+
+void advent::phase_recorder::stop() noexcept
+{
+	const auto now = std::chrono::high_resolution_clock::now();
+	active_recorder = nullptr;
+	add_time(m_current_phase, now - m_phase_start);
+	if (m_current_phase != UNPHASED)
+	{
+		advent::trace::add_span(m_current_phase, "phase", m_phase_start, now);
+	}
+}
+
+std::vector<advent::phase_timing> advent::phase_recorder::get_phases() const
+{
+	if (!m_any_phases)
+	{
+		return {};
+	}
+	std::vector<phase_timing> result;
+	result.reserve(m_phases.size());
+	for (const raw_phase& phase : m_phases)
+	{
+		// Only mention the unphased time if there was some.
+		if (phase.name == UNPHASED && phase.time.count() == 0) continue;
+		result.push_back(phase_timing{ std::string{ phase.name }, phase.time });
+	}
+	return result;
+}
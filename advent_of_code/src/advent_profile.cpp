@@ -0,0 +1,105 @@
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "../advent/advent_profile.h"
+#include "../advent/advent_test_result.h"
+#include "../advent/advent_trace.h"
+
+thread_local advent::profile_recorder* advent::internal_helpers::active_profile_recorder = nullptr;
+
+advent::profile_recorder::profile_recorder()
+{
+	// Node 0 is the root: the test function itself.
+	m_nodes.push_back(node{ "", 0, 0, 0, 0, std::chrono::nanoseconds{ 0 } });
+}
+
+void advent::profile_recorder::start() noexcept
+{
+	// Avoid allocating while the test is running in the common case.
+	m_nodes.reserve(64);
+	m_current = 0;
+	internal_helpers::active_profile_recorder = this;
+}
+
+void advent::profile_recorder::stop() noexcept
+{
+	internal_helpers::active_profile_recorder = nullptr;
+	m_current = 0;
+	++m_num_runs;
+}
+
+std::size_t advent::profile_recorder::enter(std::string_view name)
+{
+	std::size_t* link = &m_nodes[m_current].first_child;
+	while (*link != 0)
+	{
+		if (m_nodes[*link].name == name)
+		{
+			m_current = *link;
+			return m_current;
+		}
+		link = &m_nodes[*link].next_sibling;
+	}
+
+	// Work out the index before push_back, which may move the node link points into.
+	const std::size_t new_idx = m_nodes.size();
+	*link = new_idx;
+	m_nodes.push_back(node{ name, m_current, 0, 0, 0, std::chrono::nanoseconds{ 0 } });
+	m_current = new_idx;
+	return new_idx;
+}
+
+void advent::profile_recorder::exit(std::size_t node_idx, std::chrono::high_resolution_clock::time_point start, std::chrono::high_resolution_clock::time_point end) noexcept
+{
+	node& n = m_nodes[node_idx];
+	++n.calls;
+	n.inclusive_time += end - start;
+	m_current = n.parent;
+	trace::add_span(n.name, "scope", start, end);
+}
+
+advent::profile_node advent::profile_recorder::make_tree(std::size_t node_idx) const
+{
+	const node& n = m_nodes[node_idx];
+	const auto num_runs = std::max(m_num_runs, std::size_t{ 1 });
+	profile_node result;
+	result.name = std::string{ n.name };
+	result.calls = n.calls / num_runs;
+	result.inclusive_time = n.inclusive_time / num_runs;
+	result.exclusive_time = result.inclusive_time;
+	for (std::size_t child = n.first_child; child != 0; child = m_nodes[child].next_sibling)
+	{
+		result.children.push_back(make_tree(child));
+		result.exclusive_time -= result.children.back().inclusive_time;
+	}
+	return result;
+}
+
+std::vector<advent::profile_node> advent::profile_recorder::get_tree() const
+{
+	return make_tree(0).children;
+}
+
+namespace
+{
+	void write_tree(std::ostream& out, const std::vector<advent::profile_node>& nodes, int depth)
+	{
+		for (const advent::profile_node& n : nodes)
+		{
+			const std::string indented_name = std::string(static_cast<std::size_t>(2 * depth), ' ') + n.name;
+			out << "      " << std::left << std::setw(32) << indented_name << std::right
+				<< " calls=" << n.calls
+				<< " incl=" << ::to_human_readable(n.inclusive_time)
+				<< " excl=" << ::to_human_readable(n.exclusive_time) << '\n';
+			write_tree(out, n.children, depth + 1);
+		}
+	}
+}
+
+std::string advent::to_human_readable(const std::vector<profile_node>& tree)
+{
+	std::ostringstream oss;
+	write_tree(oss, tree, 0);
+	return oss.str();
+}
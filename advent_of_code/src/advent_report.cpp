@@ -0,0 +1,541 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+
+#include "../advent/advent_report.h"
+#include "../advent/advent_of_code.h"
+#include "../advent/advent_stability.h"
+
+// These are normally set by CMakeLists.txt.
+#ifndef ADVENT_GIT_COMMIT
+#define ADVENT_GIT_COMMIT "unknown"
+#endif
+#ifndef ADVENT_BUILD_CONFIG
+#define ADVENT_BUILD_CONFIG "unknown"
+#endif
+#ifndef ADVENT_CXX_FLAGS
+#define ADVENT_CXX_FLAGS ""
+#endif
+#ifndef ADVENT_COMPILER
+#define ADVENT_COMPILER "unknown"
+#endif
+
+namespace
+{
+	advent::json::value to_json(const std::vector<advent::profile_node>& nodes)
+	{
+		advent::json::array result;
+		for (const advent::profile_node& node : nodes)
+		{
+			advent::json::value node_json;
+			node_json.set("name", node.name);
+			node_json.set("calls", node.calls);
+			node_json.set("inclusive_ns", node.inclusive_time.count());
+			node_json.set("exclusive_ns", node.exclusive_time.count());
+			if (!node.children.empty())
+			{
+				node_json.set("children", to_json(node.children));
+			}
+			result.push_back(std::move(node_json));
+		}
+		return result;
+	}
+
+	std::vector<advent::profile_node> profile_from_json(const advent::json::value& v)
+	{
+		std::vector<advent::profile_node> result;
+		if (!v.is_array()) return result;
+		for (const advent::json::value& node_json : v.as_array())
+		{
+			advent::profile_node node;
+			node.name = node_json.get_string("name");
+			node.calls = static_cast<uint64_t>(node_json.get_int("calls"));
+			node.inclusive_time = std::chrono::nanoseconds{ node_json.get_int("inclusive_ns") };
+			node.exclusive_time = std::chrono::nanoseconds{ node_json.get_int("exclusive_ns") };
+			if (const advent::json::value* children = node_json.find("children"))
+			{
+				node.children = profile_from_json(*children);
+			}
+			result.push_back(std::move(node));
+		}
+		return result;
+	}
+
+	advent::json::value to_json(const advent::timing_stats& timing)
+	{
+		advent::json::value result;
+		result.set("samples", timing.num_samples);
+		result.set("min_ns", timing.min.count());
+		result.set("median_ns", timing.median.count());
+		result.set("mean_ns", timing.mean.count());
+		result.set("p95_ns", timing.p95.count());
+		result.set("max_ns", timing.max.count());
+		result.set("stddev_ns", timing.stddev.count());
+		return result;
+	}
+
+	advent::timing_stats timing_stats_from_json(const advent::json::value& v)
+	{
+		using std::chrono::nanoseconds;
+		advent::timing_stats result;
+		result.num_samples = static_cast<std::size_t>(v.get_int("samples"));
+		result.min = nanoseconds{ v.get_int("min_ns") };
+		result.median = nanoseconds{ v.get_int("median_ns") };
+		result.mean = nanoseconds{ v.get_int("mean_ns") };
+		result.p95 = nanoseconds{ v.get_int("p95_ns") };
+		result.max = nanoseconds{ v.get_int("max_ns") };
+		result.stddev = nanoseconds{ v.get_int("stddev_ns") };
+		return result;
+	}
+
+	advent::json::value to_json(const advent::perf_counter_values& counters)
+	{
+		advent::json::value result = advent::json::object{};
+		auto add = [&result](std::string_view name, const std::optional<uint64_t>& value)
+		{
+			if (value.has_value()) result.set(name, *value);
+		};
+		add("cycles", counters.cycles);
+		add("instructions", counters.instructions);
+		add("l1d_read_misses", counters.l1d_read_misses);
+		add("llc_misses", counters.llc_misses);
+		add("branch_misses", counters.branch_misses);
+		if (const auto ipc = counters.instructions_per_cycle())
+		{
+			result.set("ipc", *ipc);
+		}
+		return result;
+	}
+
+	advent::perf_counter_values perf_counter_values_from_json(const advent::json::value& v)
+	{
+		auto get = [&v](std::string_view name) -> std::optional<uint64_t>
+		{
+			const advent::json::value* value = v.find(name);
+			if (value == nullptr || !value->is_number()) return std::nullopt;
+			return static_cast<uint64_t>(value->as_int());
+		};
+		advent::perf_counter_values result;
+		result.cycles = get("cycles");
+		result.instructions = get("instructions");
+		result.l1d_read_misses = get("l1d_read_misses");
+		result.llc_misses = get("llc_misses");
+		result.branch_misses = get("branch_misses");
+		return result;
+	}
+
+	advent::json::value to_json(const advent::cpu_usage& cpu)
+	{
+		advent::json::value result;
+		result.set("wall_ns", cpu.wall.count());
+		result.set("thread_cpu_ns", cpu.thread_cpu.count());
+		result.set("process_user_ns", cpu.process_user.count());
+		result.set("process_system_ns", cpu.process_system.count());
+		result.set("parallelism", cpu.parallelism());
+		result.set("voluntary_switches", cpu.voluntary_switches);
+		result.set("involuntary_switches", cpu.involuntary_switches);
+		result.set("minor_faults", cpu.minor_faults);
+		result.set("major_faults", cpu.major_faults);
+		return result;
+	}
+
+	advent::cpu_usage cpu_usage_from_json(const advent::json::value& v)
+	{
+		using std::chrono::nanoseconds;
+		advent::cpu_usage result;
+		result.wall = nanoseconds{ v.get_int("wall_ns") };
+		result.thread_cpu = nanoseconds{ v.get_int("thread_cpu_ns") };
+		result.process_user = nanoseconds{ v.get_int("process_user_ns") };
+		result.process_system = nanoseconds{ v.get_int("process_system_ns") };
+		result.voluntary_switches = static_cast<uint64_t>(v.get_int("voluntary_switches"));
+		result.involuntary_switches = static_cast<uint64_t>(v.get_int("involuntary_switches"));
+		result.minor_faults = static_cast<uint64_t>(v.get_int("minor_faults"));
+		result.major_faults = static_cast<uint64_t>(v.get_int("major_faults"));
+		return result;
+	}
+
+	advent::json::value to_json(const advent::allocation_stats& allocations)
+	{
+		advent::json::value result;
+		result.set("count", allocations.num_allocations);
+		result.set("bytes", allocations.bytes_allocated);
+		result.set("peak_bytes", allocations.peak_live_bytes);
+		return result;
+	}
+
+	advent::allocation_stats allocation_stats_from_json(const advent::json::value& v)
+	{
+		advent::allocation_stats result;
+		result.num_allocations = static_cast<uint64_t>(v.get_int("count"));
+		result.bytes_allocated = static_cast<uint64_t>(v.get_int("bytes"));
+		result.peak_live_bytes = static_cast<uint64_t>(v.get_int("peak_bytes"));
+		return result;
+	}
+
+	std::string csv_field(const std::optional<uint64_t>& value)
+	{
+		return value.has_value() ? std::to_string(*value) : std::string{};
+	}
+
+	std::string csv_escape(std::string_view field)
+	{
+		if (field.find_first_of(",\"\n\r") == std::string_view::npos)
+		{
+			return std::string{ field };
+		}
+		std::string result{ '"' };
+		for (char c : field)
+		{
+			if (c == '"') result.push_back('"');
+			result.push_back(c);
+		}
+		result.push_back('"');
+		return result;
+	}
+
+	// A run metadata value as a CSV field. Lists are joined with "; ".
+	std::string csv_metadata_field(const advent::json::value& value)
+	{
+		if (value.is_string())
+		{
+			return csv_escape(value.as_string());
+		}
+		if (value.is_array())
+		{
+			std::string joined;
+			for (const advent::json::value& item : value.as_array())
+			{
+				joined += (joined.empty() ? "" : "; ") + (item.is_string() ? item.as_string() : advent::json::to_string(item));
+			}
+			return csv_escape(joined);
+		}
+		return csv_escape(advent::json::to_string(value));
+	}
+
+	bool write_csv_report(const std::string& filename, std::span<const test_result> results, const run_options& options)
+	{
+		std::ofstream file{ filename, std::ios::binary };
+		if (!file.is_open()) return false;
+
+		// The same run metadata as the JSON report, repeated on every row so each row stands alone.
+		const advent::json::value metadata = advent::get_run_metadata(options);
+		std::string metadata_header;
+		std::string metadata_fields;
+		for (const auto& [key, value] : metadata.as_object())
+		{
+			metadata_header += ',' + key;
+			metadata_fields += ',' + csv_metadata_field(value);
+		}
+
+		file << "name,status,result,expected,time_ns,input_load_ns,input_parse_ns,samples,min_ns,median_ns,mean_ns,p95_ns,max_ns,stddev_ns,cycles,instructions,ipc,l1d_read_misses,llc_misses,branch_misses,thread_cpu_ns,process_cpu_ns,parallelism,context_switches,page_faults,allocations,allocated_bytes,peak_bytes"
+			<< metadata_header << '\n';
+		for (const test_result& result : results)
+		{
+			const advent::timing_stats& t = result.timing;
+			file << csv_escape(result.name) << ','
+				<< to_string(result.status) << ','
+				<< csv_escape(result.result) << ','
+				<< csv_escape(result.expected) << ','
+				<< result.time_taken.count() << ','
+				<< result.input_load_time.count() << ','
+				<< (result.input_parse ? std::to_string(result.input_parse->time.count()) : "") << ','
+				<< t.num_samples << ','
+				<< t.min.count() << ','
+				<< t.median.count() << ','
+				<< t.mean.count() << ','
+				<< t.p95.count() << ','
+				<< t.max.count() << ','
+				<< t.stddev.count() << ','
+				<< csv_field(result.counters.cycles) << ','
+				<< csv_field(result.counters.instructions) << ','
+				<< result.counters.instructions_per_cycle().value_or(0.0) << ','
+				<< csv_field(result.counters.l1d_read_misses) << ','
+				<< csv_field(result.counters.llc_misses) << ','
+				<< csv_field(result.counters.branch_misses) << ','
+				<< (result.cpu ? std::to_string(result.cpu->thread_cpu.count()) : "") << ','
+				<< (result.cpu ? std::to_string(result.cpu->process_cpu().count()) : "") << ','
+				<< (result.cpu ? std::to_string(result.cpu->parallelism()) : "") << ','
+				<< (result.cpu ? std::to_string(result.cpu->voluntary_switches + result.cpu->involuntary_switches) : "") << ','
+				<< (result.cpu ? std::to_string(result.cpu->minor_faults + result.cpu->major_faults) : "") << ','
+				<< (result.allocations ? std::to_string(result.allocations->num_allocations) : "") << ','
+				<< (result.allocations ? std::to_string(result.allocations->bytes_allocated) : "") << ','
+				<< (result.allocations ? std::to_string(result.allocations->peak_live_bytes) : "")
+				<< metadata_fields << '\n';
+		}
+		return static_cast<bool>(file);
+	}
+
+	bool write_json_report(const std::string& filename, std::span<const test_result> results, const run_options& options)
+	{
+		advent::json::array tests;
+		tests.reserve(results.size());
+		std::ranges::transform(results, std::back_inserter(tests), [](const test_result& r) { return advent::to_json(r); });
+
+		advent::json::value report;
+		report.set("run", advent::get_run_metadata(options));
+		report.set("tests", std::move(tests));
+		return advent::json::write_file(filename, report);
+	}
+}
+
+advent::json::value advent::get_run_metadata(const run_options& options)
+{
+	json::value result;
+	const auto now = std::chrono::system_clock::now().time_since_epoch();
+	result.set("timestamp", std::chrono::duration_cast<std::chrono::seconds>(now).count());
+	result.set("git_commit", ADVENT_GIT_COMMIT);
+	result.set("compiler", ADVENT_COMPILER);
+	result.set("build_config", ADVENT_BUILD_CONFIG);
+	result.set("cxx_flags", ADVENT_CXX_FLAGS);
+#ifdef NDEBUG
+	result.set("ndebug", true);
+#else
+	result.set("ndebug", false);
+#endif
+	result.set("jobs", options.num_jobs);
+	result.set("warmup_runs", options.warmup_runs);
+	result.set("repetitions", options.repetitions);
+	result.set("time_budget_ms", options.time_budget.count());
+	if (options.pin_cpu.has_value())
+	{
+		result.set("pin_cpu", *options.pin_cpu);
+	}
+	result.set("high_priority", options.high_priority);
+	result.set("cpu_governor", get_cpu_governor(options.pin_cpu.value_or(0)));
+	json::array noise_sources;
+	std::ranges::transform(find_timing_noise_sources(options.pin_cpu), std::back_inserter(noise_sources),
+		[](const std::string& source) { return json::value{ source }; });
+	result.set("timing_noise", std::move(noise_sources));
+	result.set("perf_counters", options.perf_counters);
+	result.set("measure_cpu", options.measure_cpu);
+	result.set("profile", options.profile);
+	result.set("allocation_tracking", allocation_tracking_enabled());
+	result.set("isolate", options.isolate);
+	result.set("timeout_ms", options.timeout.count());
+	result.set("cache", options.cache_file);
+	result.set("force", options.force);
+	result.set("trace", options.trace_file);
+	result.set("sample_dir", options.sample_dir);
+	result.set("sample_frequency", options.sample_frequency);
+	return result;
+}
+
+advent::json::value advent::to_json(const test_result& result)
+{
+	json::value v;
+	v.set("name", result.name);
+	v.set("status", to_string(result.status));
+	v.set("result", result.result);
+	v.set("expected", result.expected);
+	v.set("time_ns", result.time_taken.count());
+	v.set("input_load_ns", result.input_load_time.count());
+	if (result.input_parse.has_value())
+	{
+		v.set("input_parse_ns", result.input_parse->time.count());
+		v.set("input_parse_reused", result.input_parse->reused);
+	}
+	if (result.from_cache)
+	{
+		v.set("cached", true);
+	}
+	if (!result.phases.empty())
+	{
+		json::array phases;
+		for (const phase_timing& phase : result.phases)
+		{
+			json::value phase_json;
+			phase_json.set("name", phase.name);
+			phase_json.set("time_ns", phase.time.count());
+			phases.push_back(std::move(phase_json));
+		}
+		v.set("phases", std::move(phases));
+	}
+	if (!result.profile.empty())
+	{
+		v.set("profile", ::to_json(result.profile));
+	}
+	v.set("timing", ::to_json(result.timing));
+	if (!result.counters.empty())
+	{
+		v.set("counters", ::to_json(result.counters));
+	}
+	if (result.cpu.has_value())
+	{
+		v.set("cpu", ::to_json(*result.cpu));
+	}
+	if (result.allocations.has_value())
+	{
+		v.set("allocations", ::to_json(*result.allocations));
+	}
+	return v;
+}
+
+std::optional<test_result> advent::test_result_from_json(const json::value& v)
+{
+	if (!v.is_object()) return std::nullopt;
+	const auto status = test_status_from_string(v.get_string("status"));
+	if (!status.has_value()) return std::nullopt;
+
+	test_result result;
+	result.name = v.get_string("name");
+	result.status = *status;
+	result.result = v.get_string("result");
+	result.expected = v.get_string("expected");
+	result.time_taken = std::chrono::nanoseconds{ v.get_int("time_ns") };
+	result.input_load_time = std::chrono::nanoseconds{ v.get_int("input_load_ns") };
+	if (v.find("input_parse_ns") != nullptr)
+	{
+		const json::value* reused = v.find("input_parse_reused");
+		result.input_parse = ParseTiming{ std::chrono::nanoseconds{ v.get_int("input_parse_ns") }, reused != nullptr && reused->is_bool() && reused->as_bool() };
+	}
+	if (const json::value* cached = v.find("cached"); cached != nullptr && cached->is_bool())
+	{
+		result.from_cache = cached->as_bool();
+	}
+	if (const json::value* phases = v.find("phases"); phases != nullptr && phases->is_array())
+	{
+		for (const json::value& phase : phases->as_array())
+		{
+			result.phases.push_back(phase_timing{ phase.get_string("name"), std::chrono::nanoseconds{ phase.get_int("time_ns") } });
+		}
+	}
+	if (const json::value* profile = v.find("profile"))
+	{
+		result.profile = profile_from_json(*profile);
+	}
+	if (const json::value* timing = v.find("timing"))
+	{
+		result.timing = timing_stats_from_json(*timing);
+	}
+	if (const json::value* counters = v.find("counters"))
+	{
+		result.counters = perf_counter_values_from_json(*counters);
+	}
+	if (const json::value* cpu = v.find("cpu"))
+	{
+		result.cpu = cpu_usage_from_json(*cpu);
+	}
+	if (const json::value* allocations = v.find("allocations"))
+	{
+		result.allocations = allocation_stats_from_json(*allocations);
+	}
+	return result;
+}
+
+bool advent::write_report(const std::string& filename, std::span<const test_result> results, const run_options& options)
+{
+	if (filename.ends_with(".csv"))
+	{
+		return write_csv_report(filename, results, options);
+	}
+	return write_json_report(filename, results, options);
+}
+
+bool advent::write_batch_report(const std::string& filename, std::span<const batch_file_result> results, const batch_summary& summary, const run_options& options)
+{
+	if (filename.ends_with(".csv"))
+	{
+		std::ofstream file{ filename, std::ios::binary };
+		if (!file.is_open()) return false;
+		file << "file,day,bytes,load_ns,parse_ns,test,result,error,time_ns\n";
+		for (const batch_file_result& r : results)
+		{
+			for (const batch_test_result& test : r.tests)
+			{
+				file << csv_escape(r.filename) << ',' << r.day << ',' << r.bytes << ',' << r.load_time.count() << ',' << r.parse_time.count() << ','
+					<< csv_escape(test.test_name) << ',' << csv_escape(test.result) << ',' << (test.error ? "true" : "false") << ','
+					<< test.time.count() << '\n';
+			}
+		}
+		return static_cast<bool>(file);
+	}
+
+	json::array files;
+	for (const batch_file_result& r : results)
+	{
+		json::array tests;
+		for (const batch_test_result& test : r.tests)
+		{
+			json::value test_json;
+			test_json.set("name", test.test_name);
+			test_json.set("result", test.result);
+			test_json.set("error", test.error);
+			test_json.set("time_ns", test.time.count());
+			tests.push_back(std::move(test_json));
+		}
+		json::value file_json;
+		file_json.set("file", r.filename);
+		file_json.set("day", r.day);
+		file_json.set("bytes", r.bytes);
+		file_json.set("load_ns", r.load_time.count());
+		file_json.set("parse_ns", r.parse_time.count());
+		file_json.set("read_error", r.read_error);
+		file_json.set("tests", std::move(tests));
+		files.push_back(std::move(file_json));
+	}
+
+	json::value summary_json;
+	summary_json.set("files", summary.num_files);
+	summary_json.set("errors", summary.num_errors);
+	summary_json.set("bytes", summary.total_bytes);
+	summary_json.set("solve_ns", summary.solve_time.count());
+	summary_json.set("wall_ns", summary.wall_time.count());
+	summary_json.set("files_per_second", summary.files_per_second());
+	summary_json.set("megabytes_per_second", summary.megabytes_per_second());
+
+	json::value report;
+	report.set("run", get_run_metadata(options));
+	report.set("batch", std::move(summary_json));
+	report.set("files", std::move(files));
+	return json::write_file(filename, report);
+}
+
+bool advent::check_against_baseline(const std::string& filename, std::span<const test_result> results, double threshold, std::ostream& out)
+{
+	const auto baseline = json::read_file(filename);
+	const json::value* baseline_tests = baseline.has_value() ? baseline->find("tests") : nullptr;
+	if (baseline_tests == nullptr || !baseline_tests->is_array())
+	{
+		out << "BASELINE: could not read '" << filename << "'\n";
+		return false;
+	}
+
+	std::size_t num_compared = 0;
+	std::size_t num_regressed = 0;
+	std::size_t num_improved = 0;
+	out << "BASELINE (" << filename << ", threshold " << threshold * 100.0 << "%):\n";
+	for (const json::value& baseline_json : baseline_tests->as_array())
+	{
+		const auto old_result = test_result_from_json(baseline_json);
+		if (!old_result.has_value() || old_result->status == test_status::filtered) continue;
+
+		const auto new_result = std::ranges::find(results, old_result->name, &test_result::name);
+		if (new_result == end(results) || new_result->status == test_status::filtered) continue;
+
+		++num_compared;
+		const auto old_ns = static_cast<double>(std::max(old_result->time_taken.count(), decltype(old_result->time_taken.count()){ 1 }));
+		const auto new_ns = static_cast<double>(new_result->time_taken.count());
+		const double change = (new_ns - old_ns) / old_ns;
+		if (change > threshold)
+		{
+			++num_regressed;
+			out << "    REGRESSED: ";
+		}
+		else if (change < -threshold)
+		{
+			++num_improved;
+			out << "    IMPROVED : ";
+		}
+		else
+		{
+			continue;
+		}
+		out << new_result->name << ' ' << ::to_human_readable(old_result->time_taken) << " -> " << ::to_human_readable(new_result->time_taken)
+			<< " (" << std::fixed << std::setprecision(1) << std::showpos << change * 100.0 << std::noshowpos << std::defaultfloat << "%)\n";
+	}
+	out << "    " << num_compared << " compared, " << num_regressed << " regressed, " << num_improved << " improved\n";
+	return num_regressed == 0;
+}
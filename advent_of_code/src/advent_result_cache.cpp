@@ -0,0 +1,366 @@
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <vector>
+#include <charconv>
+#include <algorithm>
+#include <system_error>
+#include <iostream>
+
+#include "../advent/advent_result_cache.h"
+#include "../advent/advent_report.h"
+#include "../advent/advent_of_code.h"
+#include "../advent/advent_utils.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	constexpr int CACHE_VERSION = 1;
+
+	// 64-bit FNV-1a. Not cryptographic, but plenty to notice that a file changed.
+	class hasher
+	{
+		uint64_t m_hash = 14695981039346656037ull;
+	public:
+		void add(std::string_view data) noexcept
+		{
+			for (char c : data)
+			{
+				m_hash ^= static_cast<unsigned char>(c);
+				m_hash *= 1099511628211ull;
+			}
+			// Separate consecutive strings so ("ab","c") and ("a","bc") differ.
+			m_hash ^= 0xff;
+			m_hash *= 1099511628211ull;
+		}
+
+		void add(uint64_t value) noexcept
+		{
+			char bytes[sizeof(value)];
+			for (char& b : bytes)
+			{
+				b = static_cast<char>(value & 0xff);
+				value >>= 8;
+			}
+			add(std::string_view{ bytes, sizeof(bytes) });
+		}
+
+		uint64_t get() const noexcept { return m_hash; }
+	};
+
+	std::optional<std::string> read_whole_file(const fs::path& path)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		if (!file.is_open())
+		{
+			return std::nullopt;
+		}
+		std::ostringstream contents;
+		contents << file.rdbuf();
+		return std::move(contents).str();
+	}
+
+	bool is_source_file(const fs::path& path)
+	{
+		const fs::path ext = path.extension();
+		return ext == ".cpp" || ext == ".h" || ext == ".hpp";
+	}
+
+	// Local includes are looked up next to the including file, then from the project root, then in utils.
+	std::optional<fs::path> resolve_include(const fs::path& including_file, std::string_view name)
+	{
+		for (const fs::path& base : { including_file.parent_path(), fs::path{}, fs::path{ "utils" } })
+		{
+			const fs::path candidate = (base / name).lexically_normal();
+			std::error_code ec;
+			if (fs::is_regular_file(candidate, ec))
+			{
+				return candidate;
+			}
+		}
+		return std::nullopt;
+	}
+
+	// Where a header's out-of-line definitions live, if it has any: next to it, or in src for the framework
+	// and utils headers. Headers without one are taken to be header-only.
+	std::optional<fs::path> find_implementation(const fs::path& header)
+	{
+		if (header.extension() == ".cpp")
+		{
+			return std::nullopt;
+		}
+		fs::path filename = header.filename();
+		filename.replace_extension(".cpp");
+		for (const fs::path& base : { header.parent_path(), fs::path{ "src" } })
+		{
+			const fs::path candidate = (base / filename).lexically_normal();
+			std::error_code ec;
+			if (fs::is_regular_file(candidate, ec))
+			{
+				return candidate;
+			}
+		}
+		return std::nullopt;
+	}
+
+	std::vector<std::string_view> get_local_includes(std::string_view contents)
+	{
+		std::vector<std::string_view> result;
+		while (!contents.empty())
+		{
+			const std::size_t line_end = std::min(contents.find('\n'), contents.size());
+			std::string_view line = contents.substr(0, line_end);
+			contents.remove_prefix(std::min(line_end + 1, contents.size()));
+
+			line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+			if (!line.starts_with("#include"))
+			{
+				continue;
+			}
+			const std::size_t open_quote = line.find('"');
+			const std::size_t close_quote = line.find('"', open_quote + 1);
+			if (open_quote < line.size() && close_quote < line.size())
+			{
+				result.push_back(line.substr(open_quote + 1, close_quote - open_quote - 1));
+			}
+		}
+		return result;
+	}
+
+	std::string to_hex(uint64_t value)
+	{
+		std::ostringstream oss;
+		oss << std::hex << value;
+		return oss.str();
+	}
+
+	std::optional<uint64_t> from_hex(std::string_view str)
+	{
+		uint64_t result = 0;
+		const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), result, 16);
+		if (ec != std::errc{} || ptr != str.data() + str.size() || str.empty())
+		{
+			return std::nullopt;
+		}
+		return result;
+	}
+}
+
+advent::result_cache::result_cache(std::string filename, fs::path program_path)
+	: m_filename{ std::move(filename) }, m_program_path{ std::move(program_path) }
+{
+	std::error_code ec;
+	if (fs::exists("/proc/self/exe", ec))
+	{
+		m_program_path = "/proc/self/exe";
+	}
+
+	const auto loaded = json::read_file(m_filename);
+	if (loaded.has_value() && loaded->get_int("version") == CACHE_VERSION)
+	{
+		if (const json::value* tests = loaded->find("tests"); tests != nullptr && tests->is_object())
+		{
+			m_entries = *tests;
+		}
+	}
+	if (!m_entries.is_object())
+	{
+		m_entries = json::object{};
+	}
+}
+
+// Hashes everything in the day's directory, the framework's sources, every local header reachable from
+// those and the .cpp that goes with each header. Falls back to the binary's hash if the sources can't be
+// found from the current directory, and returns std::nullopt if any source is newer than the program.
+std::optional<uint64_t> advent::result_cache::get_day_hash(int day)
+{
+	const fs::path day_dir = fs::path{ puzzle_input_filename(day) }.parent_path();
+	const fs::path framework_dir{ "src" };
+	std::error_code ec;
+	if (!fs::is_directory(day_dir, ec) || !fs::is_directory(framework_dir, ec))
+	{
+		if (!m_warned_no_sources)
+		{
+			std::cerr << "Warning: can't find the sources from " << fs::current_path(ec).string()
+				<< ", so cached results are keyed on the whole program. Run from the advent_of_code folder to fix this.\n";
+			m_warned_no_sources = true;
+		}
+		return get_binary_hash();
+	}
+
+	std::set<fs::path> files;
+	std::vector<fs::path> to_scan;
+	for (const fs::path& dir : { day_dir, framework_dir })
+	{
+		for (const fs::directory_entry& entry : fs::directory_iterator{ dir, ec })
+		{
+			if (!entry.is_regular_file(ec))
+			{
+				continue;
+			}
+			const fs::path path = entry.path().lexically_normal();
+			const bool is_source = is_source_file(path);
+			// Only the framework's sources matter: anything else in src isn't built into the program.
+			if (dir == framework_dir && !is_source)
+			{
+				continue;
+			}
+			files.insert(path);
+			if (is_source)
+			{
+				to_scan.push_back(path);
+			}
+		}
+	}
+
+	const auto program_time = fs::last_write_time(m_program_path, ec);
+	const bool check_program_time = !ec;
+
+	hasher h;
+	std::map<fs::path, std::string> contents;
+	while (!to_scan.empty())
+	{
+		const fs::path file = std::move(to_scan.back());
+		to_scan.pop_back();
+		if (check_program_time && fs::last_write_time(file, ec) > program_time && !ec)
+		{
+			return std::nullopt;
+		}
+		auto file_contents = read_whole_file(file);
+		if (!file_contents.has_value())
+		{
+			continue;
+		}
+		for (std::string_view include : get_local_includes(*file_contents))
+		{
+			const auto resolved = resolve_include(file, include);
+			if (!resolved.has_value())
+			{
+				continue;
+			}
+			if (files.insert(*resolved).second)
+			{
+				to_scan.push_back(*resolved);
+			}
+			if (const auto implementation = find_implementation(*resolved); implementation.has_value() && files.insert(*implementation).second)
+			{
+				to_scan.push_back(*implementation);
+			}
+		}
+		contents.emplace(file, std::move(*file_contents));
+	}
+
+	// std::set keeps the paths sorted so the hash doesn't depend on directory iteration order.
+	for (const fs::path& file : files)
+	{
+		h.add(file.generic_string());
+		if (const auto found = contents.find(file); found != end(contents))
+		{
+			h.add(found->second);
+		}
+		else if (const auto file_contents = read_whole_file(file))
+		{
+			h.add(*file_contents);
+		}
+	}
+
+	// The same sources built differently can give different results (and certainly different timings).
+	const json::value build = get_run_metadata(run_options{});
+	for (std::string_view key : { "compiler", "build_config", "cxx_flags" })
+	{
+		h.add(build.get_string(key));
+	}
+	h.add(static_cast<uint64_t>(build.find("ndebug") != nullptr && build.find("ndebug")->as_bool()));
+	return h.get();
+}
+
+uint64_t advent::result_cache::get_binary_hash()
+{
+	if (!m_binary_hash.has_value())
+	{
+		hasher h;
+		h.add(read_whole_file(m_program_path).value_or(""));
+		m_binary_hash = h.get();
+	}
+	return *m_binary_hash;
+}
+
+std::optional<uint64_t> advent::result_cache::get_key(std::string_view test_name, const std::string& expected, std::optional<int> day)
+{
+	std::scoped_lock guard{ m_lock };
+	std::optional<uint64_t> code_hash;
+	if (day.has_value())
+	{
+		auto found = m_day_hashes.find(*day);
+		if (found == end(m_day_hashes))
+		{
+			found = m_day_hashes.emplace(*day, get_day_hash(*day)).first;
+		}
+		code_hash = found->second;
+		if (!code_hash.has_value())
+		{
+			return std::nullopt;
+		}
+	}
+	else
+	{
+		code_hash = get_binary_hash();
+	}
+
+	hasher h;
+	h.add(*code_hash);
+	h.add(test_name);
+	h.add(expected);
+	return h.get();
+}
+
+std::optional<test_result> advent::result_cache::find(std::string_view test_name, uint64_t key)
+{
+	std::scoped_lock guard{ m_lock };
+	const json::value* entry = m_entries.find(test_name);
+	if (entry == nullptr || from_hex(entry->get_string("key")) != key)
+	{
+		return std::nullopt;
+	}
+	const json::value* result_json = entry->find("result");
+	auto result = result_json != nullptr ? test_result_from_json(*result_json) : std::nullopt;
+	if (result.has_value())
+	{
+		result->from_cache = true;
+	}
+	return result;
+}
+
+void advent::result_cache::store(const test_result& result, uint64_t key)
+{
+	switch (result.status)
+	{
+	case test_status::pass:
+	case test_status::fail:
+	case test_status::unknown:
+		break;
+	default:
+		return;
+	}
+
+	json::value entry;
+	entry.set("key", to_hex(key));
+	entry.set("result", to_json(result));
+	std::scoped_lock guard{ m_lock };
+	m_entries.set(result.name, std::move(entry));
+	m_modified = true;
+}
+
+bool advent::result_cache::save()
+{
+	std::scoped_lock guard{ m_lock };
+	if (!m_modified)
+	{
+		return true;
+	}
+	json::value file;
+	file.set("version", CACHE_VERSION);
+	file.set("tests", m_entries);
+	return json::write_file(m_filename, file);
+}
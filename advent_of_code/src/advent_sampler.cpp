@@ -0,0 +1,294 @@
+#include <sstream>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <filesystem>
+#include <span>
+
+#include "../advent/advent_sampler.h"
+#include "../advent/advent_assert.h"
+
+#ifdef __linux__
+#include <signal.h>
+#include <time.h>
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+
+// Older glibc headers don't name the field used with SIGEV_THREAD_ID.
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace
+{
+	// Deep enough for any sensible solution, and keeps the buffer a manageable size.
+	constexpr std::size_t MAX_FRAMES = 64;
+
+	// About 16 seconds of CPU at 1000Hz. Past this, samples are counted as dropped.
+	constexpr std::size_t MAX_SAMPLES = 16 * 1024;
+
+	std::string demangle(const char* name)
+	{
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+		if (status == 0 && demangled != nullptr)
+		{
+			std::string result{ demangled };
+			std::free(demangled);
+			return result;
+		}
+		return std::string{ name };
+	}
+
+	// Folded stacks use ';' between frames and a space before the count, so those can't appear in names.
+	std::string sanitise_frame_name(std::string name)
+	{
+		std::ranges::replace(name, ';', ':');
+		std::ranges::replace(name, ' ', '_');
+		return name;
+	}
+}
+
+struct advent::sampling_profiler::impl
+{
+	timer_t timer{};
+	bool timer_created = false;
+	long interval_ns = 0;
+
+	// Written by the signal handler, so sized up front and never reallocated while sampling.
+	std::vector<void*> frames = std::vector<void*>(MAX_SAMPLES * MAX_FRAMES);
+	std::vector<int> depths = std::vector<int>(MAX_SAMPLES);
+	std::atomic<std::size_t> num_samples = 0;
+	std::atomic<std::size_t> num_dropped = 0;
+
+	// The stack when start() was called, and the first sample taken after it. Frames a sample shares
+	// with its base stack belong to the runner. A new entry is only added when the stack differs.
+	struct base_stack
+	{
+		std::size_t first_sample;
+		std::vector<void*> frames;
+	};
+	std::vector<base_stack> base_stacks;
+};
+
+namespace
+{
+	thread_local advent::sampling_profiler::impl* active_sampler = nullptr;
+
+	void on_sample(int, siginfo_t*, void*)
+	{
+		const int saved_errno = errno;
+		advent::sampling_profiler::impl* sampler = active_sampler;
+		if (sampler != nullptr)
+		{
+			const std::size_t idx = sampler->num_samples.load(std::memory_order_relaxed);
+			if (idx < MAX_SAMPLES)
+			{
+				sampler->depths[idx] = backtrace(&sampler->frames[idx * MAX_FRAMES], static_cast<int>(MAX_FRAMES));
+				sampler->num_samples.store(idx + 1, std::memory_order_relaxed);
+			}
+			else
+			{
+				sampler->num_dropped.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		errno = saved_errno;
+	}
+
+	bool install_handler()
+	{
+		static std::once_flag once;
+		static bool installed = false;
+		std::call_once(once, []()
+			{
+				// backtrace loads libgcc the first time it's called, which isn't safe inside a signal handler.
+				void* warmup[1];
+				backtrace(warmup, 1);
+
+				struct sigaction action {};
+				action.sa_sigaction = on_sample;
+				action.sa_flags = SA_SIGINFO | SA_RESTART;
+				sigemptyset(&action.sa_mask);
+				installed = sigaction(SIGPROF, &action, nullptr) == 0;
+			});
+		return installed;
+	}
+
+	// The handler and the signal trampoline are always the first two frames of a sample.
+	constexpr int HANDLER_FRAMES = 2;
+
+	std::string describe_frame(void* address)
+	{
+		// Return addresses point after the call, which may be in the next function. Step back into the call.
+		void* const lookup = static_cast<char*>(address) - 1;
+		Dl_info info{};
+		if (dladdr(lookup, &info) != 0)
+		{
+			if (info.dli_sname != nullptr)
+			{
+				return sanitise_frame_name(demangle(info.dli_sname));
+			}
+			if (info.dli_fname != nullptr)
+			{
+				// No symbol (e.g. a static function): give something addr2line can use.
+				std::ostringstream oss;
+				oss << std::filesystem::path{ info.dli_fname }.filename().string() << "+0x" << std::hex
+					<< (reinterpret_cast<uintptr_t>(lookup) - reinterpret_cast<uintptr_t>(info.dli_fbase));
+				return sanitise_frame_name(oss.str());
+			}
+		}
+		std::ostringstream oss;
+		oss << "0x" << std::hex << reinterpret_cast<uintptr_t>(lookup);
+		return oss.str();
+	}
+}
+
+advent::sampling_profiler::sampling_profiler(int frequency_hz)
+{
+	if (frequency_hz <= 0 || !install_handler())
+	{
+		return;
+	}
+	auto new_impl = std::make_unique<impl>();
+	sigevent event{};
+	event.sigev_notify = SIGEV_THREAD_ID;
+	event.sigev_signo = SIGPROF;
+	event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+	if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &new_impl->timer) != 0)
+	{
+		return;
+	}
+	new_impl->timer_created = true;
+	new_impl->interval_ns = std::max(1'000'000'000L / frequency_hz, 1L);
+	m_impl = std::move(new_impl);
+}
+
+advent::sampling_profiler::~sampling_profiler()
+{
+	if (m_impl != nullptr && m_impl->timer_created)
+	{
+		stop();
+		timer_delete(m_impl->timer);
+	}
+}
+
+bool advent::sampling_profiler::is_available() const noexcept
+{
+	return m_impl != nullptr;
+}
+
+void advent::sampling_profiler::start() noexcept
+{
+	if (m_impl == nullptr) return;
+	void* stack[MAX_FRAMES];
+	const int depth = backtrace(stack, static_cast<int>(MAX_FRAMES));
+	std::vector<impl::base_stack>& bases = m_impl->base_stacks;
+	if (bases.empty() || !std::ranges::equal(bases.back().frames, std::span{ stack, static_cast<std::size_t>(depth) }))
+	{
+		bases.push_back(impl::base_stack{ m_impl->num_samples.load(), std::vector<void*>(stack, stack + depth) });
+	}
+	active_sampler = m_impl.get();
+	itimerspec spec{};
+	spec.it_interval.tv_nsec = m_impl->interval_ns % 1'000'000'000L;
+	spec.it_interval.tv_sec = m_impl->interval_ns / 1'000'000'000L;
+	spec.it_value = spec.it_interval;
+	timer_settime(m_impl->timer, 0, &spec, nullptr);
+}
+
+void advent::sampling_profiler::stop() noexcept
+{
+	if (m_impl == nullptr) return;
+	const itimerspec disarm{};
+	timer_settime(m_impl->timer, 0, &disarm, nullptr);
+	active_sampler = nullptr;
+}
+
+std::size_t advent::sampling_profiler::num_samples() const noexcept
+{
+	return m_impl != nullptr ? m_impl->num_samples.load() : 0;
+}
+
+std::size_t advent::sampling_profiler::num_dropped() const noexcept
+{
+	return m_impl != nullptr ? m_impl->num_dropped.load() : 0;
+}
+
+std::string advent::sampling_profiler::get_folded_stacks() const
+{
+	if (m_impl == nullptr) return "";
+
+	std::map<void*, std::string> names;
+	auto get_name = [&names](void* address) -> const std::string&
+	{
+		auto found = names.find(address);
+		if (found == end(names))
+		{
+			found = names.emplace(address, describe_frame(address)).first;
+		}
+		return found->second;
+	};
+
+	std::map<std::string, std::size_t> stacks;
+	auto next_base = begin(m_impl->base_stacks);
+	const std::vector<void*>* base_ptr = nullptr;
+	for (std::size_t sample = 0; sample < m_impl->num_samples.load(); ++sample)
+	{
+		while (next_base != end(m_impl->base_stacks) && next_base->first_sample <= sample)
+		{
+			base_ptr = &next_base->frames;
+			++next_base;
+		}
+		AdventCheck(base_ptr != nullptr);
+		const std::vector<void*>& base = *base_ptr;
+		void* const* frames = &m_impl->frames[sample * MAX_FRAMES];
+		std::size_t depth = static_cast<std::size_t>(std::max(m_impl->depths[sample], 0));
+
+		// Drop the outer frames this sample shares with the stack at start(), and then the frame that called start().
+		std::size_t shared = 0;
+		while (shared < depth && shared < base.size() && frames[depth - 1 - shared] == base[base.size() - 1 - shared])
+		{
+			++shared;
+		}
+		depth -= std::min(shared + 1, depth);
+
+		std::string stack;
+		for (std::size_t i = depth; i > static_cast<std::size_t>(HANDLER_FRAMES); --i)
+		{
+			if (!stack.empty()) stack += ';';
+			stack += get_name(frames[i - 1]);
+		}
+		if (!stack.empty())
+		{
+			++stacks[stack];
+		}
+	}
+
+	std::ostringstream oss;
+	for (const auto& [stack, count] : stacks)
+	{
+		oss << stack << ' ' << count << '\n';
+	}
+	return oss.str();
+}
+
+#else
+
+struct advent::sampling_profiler::impl {};
+
+advent::sampling_profiler::sampling_profiler(int) {}
+advent::sampling_profiler::~sampling_profiler() = default;
+bool advent::sampling_profiler::is_available() const noexcept { return false; }
+void advent::sampling_profiler::start() noexcept {}
+void advent::sampling_profiler::stop() noexcept {}
+std::size_t advent::sampling_profiler::num_samples() const noexcept { return 0; }
+std::size_t advent::sampling_profiler::num_dropped() const noexcept { return 0; }
+std::string advent::sampling_profiler::get_folded_stacks() const { return ""; }
+
+#endif
@@ -0,0 +1,197 @@
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+
+#include "../advent/advent_scaling.h"
+#include "../advent/advent_of_code.h"
+#include "../advent/advent_alloc_tracker.h"
+#include "../advent/advent_timing_stats.h"
+#include "../advent/advent_test_result.h"
+#include "../advent/advent_assert.h"
+#include "../advent/advent_utils.h"
+
+namespace
+{
+	// Runs the solver once on input, without copying it.
+	std::pair<ResultType, std::chrono::nanoseconds> time_solver(TestFuncWithArg func, const std::string& input)
+	{
+		advent::memory_streambuf buffer{ input.data(), input.size() };
+		std::istream stream{ &buffer };
+		const auto start = std::chrono::high_resolution_clock::now();
+		ResultType result = func(stream);
+		return std::pair{ std::move(result), std::chrono::high_resolution_clock::now() - start };
+	}
+
+	std::optional<double> time_of(const advent::scaling_point& point)
+	{
+		return static_cast<double>(point.time.count());
+	}
+
+	std::optional<double> memory_of(const advent::scaling_point& point)
+	{
+		return point.peak_live_bytes.has_value() ? std::optional<double>{ static_cast<double>(*point.peak_live_bytes) } : std::nullopt;
+	}
+
+	std::optional<double> fit_points(const std::vector<advent::scaling_point>& points, std::optional<double>(*get_y)(const advent::scaling_point&))
+	{
+		std::vector<std::pair<double, double>> xy;
+		for (const advent::scaling_point& point : points)
+		{
+			const std::optional<double> y = get_y(point);
+			if (y.has_value())
+			{
+				xy.emplace_back(static_cast<double>(point.scale), *y);
+			}
+		}
+		return advent::fit_growth_exponent(xy);
+	}
+
+	// Anything faster than linear is fine. This is about catching the ones that aren't.
+	constexpr double WARNING_EXPONENT = 1.5;
+}
+
+std::optional<double> advent::fit_growth_exponent(std::span<const std::pair<double, double>> points)
+{
+	double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+	std::size_t n = 0;
+	for (const auto& [x, y] : points)
+	{
+		if (x <= 0.0 || y <= 0.0) continue;
+		const double log_x = std::log(x);
+		const double log_y = std::log(y);
+		sum_x += log_x;
+		sum_y += log_y;
+		sum_xx += log_x * log_x;
+		sum_xy += log_x * log_y;
+		++n;
+	}
+	if (n < 2)
+	{
+		return std::nullopt;
+	}
+	const double denominator = static_cast<double>(n) * sum_xx - sum_x * sum_x;
+	if (denominator <= 0.0)
+	{
+		return std::nullopt;
+	}
+	return (static_cast<double>(n) * sum_xy - sum_x * sum_y) / denominator;
+}
+
+bool advent::has_superlinear_growth(const scaling_result& result) noexcept
+{
+	return std::max(result.time_exponent.value_or(0.0), result.memory_exponent.value_or(0.0)) >= WARNING_EXPONENT;
+}
+
+std::string_view advent::describe_growth(double exponent) noexcept
+{
+	if (exponent < 0.5) return "sub-linear";
+	if (exponent < 1.3) return "linear";
+	if (exponent < 1.7) return "super-linear";
+	if (exponent < 2.5) return "quadratic";
+	return "cubic or worse";
+}
+
+advent::scaling_result advent::run_scaling_test(const scaling_test& test, const run_options& options)
+{
+	scaling_result result;
+	result.name = std::string{ test.name };
+
+	std::vector<std::size_t> scales = options.scales;
+	std::ranges::sort(scales);
+	for (std::size_t scale : scales)
+	{
+		// Guess the time from the last scale, assuming it's at least linear, and skip scales that would take too long.
+		if (!result.points.empty())
+		{
+			const scaling_point& last = result.points.back();
+			const double exponent = std::max(fit_points(result.points, time_of).value_or(1.0), 1.0);
+			const double predicted_ns = static_cast<double>(last.time.count()) * std::pow(static_cast<double>(scale) / static_cast<double>(last.scale), exponent);
+			if (predicted_ns > static_cast<double>(std::chrono::nanoseconds{ options.scaling_time_limit }.count()))
+			{
+				result.skipped_scales.push_back(scale);
+				continue;
+			}
+		}
+
+		const std::string input = test.make_input(scale);
+		try
+		{
+			for (std::size_t i = 0; i < options.warmup_runs; ++i)
+			{
+				time_solver(test.func, input);
+			}
+
+			std::vector<std::chrono::nanoseconds> samples;
+			uint64_t peak_live_bytes = 0;
+			for (std::size_t i = 0; i < std::max(options.repetitions, std::size_t{ 1 }); ++i)
+			{
+				if (allocation_tracking_enabled()) start_allocation_tracking();
+				samples.push_back(time_solver(test.func, input).second);
+				if (allocation_tracking_enabled()) peak_live_bytes = std::max(peak_live_bytes, stop_allocation_tracking().peak_live_bytes);
+			}
+
+			scaling_point point;
+			point.scale = scale;
+			point.input_bytes = input.size();
+			point.time = calculate_timing_stats(std::move(samples)).median;
+			if (allocation_tracking_enabled())
+			{
+				point.peak_live_bytes = peak_live_bytes;
+			}
+			result.points.push_back(point);
+		}
+		catch (const test_failed& tf)
+		{
+			if (allocation_tracking_enabled()) stop_allocation_tracking();
+			result.error = std::string{ tf.what() };
+			break;
+		}
+	}
+
+	result.time_exponent = fit_points(result.points, time_of);
+	result.memory_exponent = fit_points(result.points, memory_of);
+	return result;
+}
+
+std::string advent::to_human_readable(const scaling_result& result)
+{
+	std::ostringstream oss;
+	oss << "    " << std::setw(8) << "scale" << std::setw(12) << "input" << std::setw(12) << "time" << std::setw(12) << "peak mem" << '\n';
+	for (const scaling_point& point : result.points)
+	{
+		oss << "    " << std::setw(7) << point.scale << 'x'
+			<< std::setw(12) << bytes_to_human_readable(point.input_bytes)
+			<< std::setw(12) << ::to_human_readable(point.time)
+			<< std::setw(12) << (point.peak_live_bytes.has_value() ? bytes_to_human_readable(*point.peak_live_bytes) : "-") << '\n';
+	}
+	for (std::size_t scale : result.skipped_scales)
+	{
+		oss << "    " << std::setw(7) << scale << "x  skipped: predicted to take longer than the scale limit\n";
+	}
+	if (result.error.has_value())
+	{
+		oss << "    ERROR: " << *result.error << '\n';
+	}
+
+	oss << std::fixed << std::setprecision(2);
+	if (result.time_exponent.has_value())
+	{
+		oss << "    time ~ n^" << *result.time_exponent << " (" << describe_growth(*result.time_exponent) << ')';
+	}
+	else
+	{
+		oss << "    time: not enough scales ran to fit a curve";
+	}
+	if (result.memory_exponent.has_value())
+	{
+		oss << "   memory ~ n^" << *result.memory_exponent << " (" << describe_growth(*result.memory_exponent) << ')';
+	}
+	oss << '\n';
+
+	if (has_superlinear_growth(result))
+	{
+		oss << "    WARNING: grows faster than linearly with the input\n";
+	}
+	return oss.str();
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+
+#include "../advent/advent_schedule.h"
+#include "../advent/advent_json.h"
+
+namespace
+{
+	constexpr int HISTORY_VERSION = 1;
+
+	// How much a new run counts towards the stored estimate.
+	constexpr double NEW_RUN_WEIGHT = 0.5;
+}
+
+advent::timing_history::timing_history(std::string filename)
+	: m_filename{ std::move(filename) }
+{
+	const auto loaded = json::read_file(m_filename);
+	if (!loaded.has_value() || loaded->get_int("version") != HISTORY_VERSION)
+	{
+		return;
+	}
+	const json::value* tests = loaded->find("tests");
+	if (tests == nullptr || !tests->is_object())
+	{
+		return;
+	}
+	for (const auto& [name, time] : tests->as_object())
+	{
+		if (time.is_number() && time.as_number() > 0.0)
+		{
+			m_times.emplace(name, std::chrono::nanoseconds{ static_cast<std::chrono::nanoseconds::rep>(time.as_number()) });
+		}
+	}
+}
+
+std::optional<std::chrono::nanoseconds> advent::timing_history::find(std::string_view test_name) const
+{
+	const auto found = m_times.find(test_name);
+	return found != end(m_times) ? std::optional{ found->second } : std::nullopt;
+}
+
+void advent::timing_history::record(std::string_view test_name, std::chrono::nanoseconds time)
+{
+	const auto found = m_times.find(test_name);
+	if (found == end(m_times))
+	{
+		m_times.emplace(std::string{ test_name }, time);
+	}
+	else
+	{
+		const double blended = NEW_RUN_WEIGHT * static_cast<double>(time.count()) + (1.0 - NEW_RUN_WEIGHT) * static_cast<double>(found->second.count());
+		found->second = std::chrono::nanoseconds{ static_cast<std::chrono::nanoseconds::rep>(blended) };
+	}
+	m_modified = true;
+}
+
+bool advent::timing_history::save() const
+{
+	if (!m_modified)
+	{
+		return true;
+	}
+	json::value tests = json::object{};
+	for (const auto& [name, time] : m_times)
+	{
+		tests.set(name, time.count());
+	}
+	json::value file;
+	file.set("version", HISTORY_VERSION);
+	file.set("tests", std::move(tests));
+	return json::write_file(m_filename, file);
+}
+
+std::vector<advent::scheduled_job> advent::schedule_longest_first(std::span<const std::string_view> names, const timing_history& history)
+{
+	std::vector<scheduled_job> result;
+	result.reserve(names.size());
+	std::vector<std::chrono::nanoseconds> known;
+	for (std::size_t i = 0; i < names.size(); ++i)
+	{
+		const std::optional<std::chrono::nanoseconds> time = history.find(names[i]);
+		result.push_back(scheduled_job{ i, time.value_or(std::chrono::nanoseconds{ 0 }), time.has_value() });
+		if (time.has_value())
+		{
+			known.push_back(*time);
+		}
+	}
+
+	if (!known.empty())
+	{
+		const auto middle = begin(known) + static_cast<std::ptrdiff_t>(known.size() / 2);
+		std::ranges::nth_element(known, middle);
+		for (scheduled_job& job : result)
+		{
+			if (!job.from_history)
+			{
+				job.estimate = *middle;
+			}
+		}
+	}
+
+	std::ranges::stable_sort(result, std::greater<>{}, &scheduled_job::estimate);
+	return result;
+}
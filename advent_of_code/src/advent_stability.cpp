@@ -0,0 +1,136 @@
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <thread>
+#include <algorithm>
+
+#include "../advent/advent_stability.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// The first line of a small sysfs file, or empty if it can't be read.
+	std::string read_first_line(const std::string& filename)
+	{
+		std::ifstream file{ filename };
+		std::string line;
+		std::getline(file, line);
+		return line;
+	}
+
+	std::string cpufreq_dir(int cpu)
+	{
+		return "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/";
+	}
+
+	// Enough work to take around a millisecond, so the clock's resolution doesn't matter.
+	constexpr uint64_t SPEED_TEST_ITERATIONS = 1 << 20;
+	constexpr int SPEED_TEST_RUNS = 5;
+}
+
+bool advent::pin_thread_to_cpu(int cpu) noexcept
+{
+#ifdef __linux__
+	if (cpu < 0 || cpu >= CPU_SETSIZE)
+	{
+		return false;
+	}
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	// pid 0 is the calling thread.
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+	static_cast<void>(cpu);
+	return false;
+#endif
+}
+
+std::optional<int> advent::raise_thread_priority() noexcept
+{
+#ifdef __linux__
+	// On Linux nice values are per thread. An unprivileged process may still be allowed some
+	// way below zero by RLIMIT_NICE, so take the lowest value that sticks.
+	const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+	for (int nice_value = -20; nice_value < 0; ++nice_value)
+	{
+		if (setpriority(PRIO_PROCESS, tid, nice_value) == 0)
+		{
+			return nice_value;
+		}
+	}
+#endif
+	return std::nullopt;
+}
+
+std::string advent::get_cpu_governor(int cpu)
+{
+	return read_first_line(cpufreq_dir(cpu) + "scaling_governor");
+}
+
+std::vector<std::string> advent::find_timing_noise_sources(std::optional<int> cpu)
+{
+	std::vector<std::string> result;
+#ifdef __linux__
+	// Count the CPUs using each governor, so one line covers them all.
+	std::map<std::string, int> governors;
+	const int first_cpu = cpu.value_or(0);
+	const int last_cpu = cpu.has_value() ? *cpu : static_cast<int>(std::thread::hardware_concurrency()) - 1;
+	for (int c = first_cpu; c <= last_cpu; ++c)
+	{
+		const std::string governor = get_cpu_governor(c);
+		if (!governor.empty() && governor != "performance")
+		{
+			++governors[governor];
+		}
+	}
+	for (const auto& [governor, num_cpus] : governors)
+	{
+		std::ostringstream oss;
+		oss << "The cpufreq governor is '" << governor << "' on " << num_cpus << (num_cpus == 1 ? " CPU" : " CPUs")
+			<< ", so clock speeds change with load. 'performance' gives steadier timings.";
+		result.push_back(oss.str());
+	}
+
+	if (read_first_line("/sys/devices/system/cpu/intel_pstate/no_turbo") == "0"
+		|| read_first_line("/sys/devices/system/cpu/cpufreq/boost") == "1")
+	{
+		result.push_back("Turbo boost is on, so clock speeds depend on temperature and on how busy the other cores are.");
+	}
+#else
+	static_cast<void>(cpu);
+#endif
+	return result;
+}
+
+std::chrono::nanoseconds advent::measure_cpu_speed() noexcept
+{
+	// A chain of dependent multiply-adds runs at a fixed number of cycles per step, whatever the memory is doing.
+	// Take the fastest of a few runs so an interruption in one of them doesn't count.
+	std::chrono::nanoseconds fastest = std::chrono::nanoseconds::max();
+	for (int run = 0; run < SPEED_TEST_RUNS; ++run)
+	{
+		volatile uint64_t seed = 1;
+		uint64_t x = seed;
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (uint64_t i = 0; i < SPEED_TEST_ITERATIONS; ++i)
+		{
+			x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+		}
+		const auto end = std::chrono::high_resolution_clock::now();
+		seed = x;
+		fastest = std::min(fastest, std::chrono::nanoseconds{ end - start });
+	}
+	return fastest;
+}
+
+bool advent::is_noisy(const timing_stats& timing, double threshold) noexcept
+{
+	return timing.num_samples >= 3 && timing.relative_stddev() > threshold;
+}
@@ -0,0 +1,164 @@
+#include <mutex>
+#include <vector>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+
+#include "../advent/advent_trace.h"
+#include "../advent/advent_json.h"
+
+namespace
+{
+	// A long --time-budget run can produce millions of spans. Past this many, new ones are dropped.
+	constexpr std::size_t MAX_EVENTS = 1'000'000;
+
+	struct span
+	{
+		std::string_view name;
+		std::string_view category;
+		advent::trace::clock::time_point start;
+		advent::trace::clock::time_point end;
+		std::size_t thread_id;
+	};
+
+	struct trace_state
+	{
+		std::mutex lock;
+		std::vector<span> spans;
+		std::vector<std::pair<std::size_t, std::string>> thread_names;
+		advent::json::value metadata;
+		std::size_t num_dropped = 0;
+		advent::trace::clock::time_point start_time;
+	};
+
+	std::atomic<bool> enabled = false;
+	std::atomic<std::size_t> next_thread_id = 0;
+
+	trace_state& get_state()
+	{
+		static trace_state state;
+		return state;
+	}
+
+	std::size_t get_thread_id() noexcept
+	{
+		thread_local const std::size_t id = next_thread_id++;
+		return id;
+	}
+
+	double to_microseconds(advent::trace::clock::duration d)
+	{
+		return std::chrono::duration<double, std::micro>{ d }.count();
+	}
+}
+
+void advent::trace::enable()
+{
+	trace_state& state = get_state();
+	{
+		std::scoped_lock guard{ state.lock };
+		state.start_time = clock::now();
+		state.spans.reserve(4096);
+	}
+	enabled = true;
+}
+
+bool advent::trace::is_enabled() noexcept
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+void advent::trace::add_span(std::string_view name, std::string_view category, clock::time_point start, clock::time_point end)
+{
+	if (!is_enabled())
+	{
+		return;
+	}
+	const std::size_t thread_id = get_thread_id();
+	trace_state& state = get_state();
+	std::scoped_lock guard{ state.lock };
+	if (state.spans.size() >= MAX_EVENTS)
+	{
+		++state.num_dropped;
+		return;
+	}
+	state.spans.push_back(span{ name, category, start, end, thread_id });
+}
+
+void advent::trace::set_thread_name(std::string name)
+{
+	if (!is_enabled())
+	{
+		return;
+	}
+	const std::size_t thread_id = get_thread_id();
+	trace_state& state = get_state();
+	std::scoped_lock guard{ state.lock };
+	const auto existing = std::ranges::find(state.thread_names, thread_id, &std::pair<std::size_t, std::string>::first);
+	if (existing != end(state.thread_names))
+	{
+		existing->second = std::move(name);
+	}
+	else
+	{
+		state.thread_names.emplace_back(thread_id, std::move(name));
+	}
+}
+
+void advent::trace::set_metadata(std::string key, json::value value)
+{
+	if (!is_enabled())
+	{
+		return;
+	}
+	trace_state& state = get_state();
+	std::scoped_lock guard{ state.lock };
+	state.metadata.set(key, std::move(value));
+}
+
+bool advent::trace::write_file(const std::string& filename)
+{
+	trace_state& state = get_state();
+	std::scoped_lock guard{ state.lock };
+
+	json::array events;
+	events.reserve(state.spans.size() + state.thread_names.size());
+	for (const auto& [thread_id, name] : state.thread_names)
+	{
+		json::value event;
+		event.set("name", "thread_name");
+		event.set("ph", "M");
+		event.set("pid", 1);
+		event.set("tid", thread_id);
+		json::value args;
+		args.set("name", name);
+		event.set("args", std::move(args));
+		events.push_back(std::move(event));
+	}
+	for (const span& s : state.spans)
+	{
+		json::value event;
+		event.set("name", s.name);
+		event.set("cat", s.category);
+		event.set("ph", "X");
+		event.set("ts", to_microseconds(s.start - state.start_time));
+		event.set("dur", to_microseconds(s.end - s.start));
+		event.set("pid", 1);
+		event.set("tid", s.thread_id);
+		events.push_back(std::move(event));
+	}
+
+	json::value file;
+	file.set("traceEvents", std::move(events));
+	file.set("displayTimeUnit", "ns");
+	json::value metadata = state.metadata;
+	if (state.num_dropped > 0)
+	{
+		metadata.set("dropped_events", state.num_dropped);
+	}
+	if (!metadata.is_null())
+	{
+		file.set("otherData", std::move(metadata));
+	}
+	return json::write_file(filename, file);
+}
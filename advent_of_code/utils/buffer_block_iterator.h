@@ -0,0 +1,213 @@
+#pragma once
+
+#include <string_view>
+#include <iterator>
+#include <cstddef>
+#include <bit>
+
+#include "buffer_line_iterator.h"
+
+// Splits a buffer that's already in memory into blocks of lines separated by blank lines (or by lines
+// matching a sentinel), without copying: each block is a string_view into the buffer.
+namespace utils
+{
+	// The first '\n' in [first,last) that's followed by a blank line ("\n" or "\r\n"), or last if there isn't one.
+	// Checks 32 positions at a time with AVX2, or 16 with SSE2.
+	inline const char* find_blank_line(const char* first, const char* last) noexcept
+	{
+#if defined(__AVX2__)
+		const __m256i newline = _mm256_set1_epi8('\n');
+		const __m256i carriage_return = _mm256_set1_epi8('\r');
+		while (last - first >= 32 + 2)
+		{
+			const __m256i here = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+			const __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 1));
+			const __m256i after_next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 2));
+			const __m256i crlf = _mm256_and_si256(_mm256_cmpeq_epi8(next, carriage_return), _mm256_cmpeq_epi8(after_next, newline));
+			const __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(next, newline), crlf);
+			const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(here, newline), blank)));
+			if (mask != 0)
+			{
+				return first + std::countr_zero(mask);
+			}
+			first += 32;
+		}
+#endif
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+		const __m128i newline16 = _mm_set1_epi8('\n');
+		const __m128i carriage_return16 = _mm_set1_epi8('\r');
+		while (last - first >= 16 + 2)
+		{
+			const __m128i here = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 1));
+			const __m128i after_next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 2));
+			const __m128i crlf = _mm_and_si128(_mm_cmpeq_epi8(next, carriage_return16), _mm_cmpeq_epi8(after_next, newline16));
+			const __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(next, newline16), crlf);
+			const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(here, newline16), blank)));
+			if (mask != 0)
+			{
+				return first + std::countr_zero(mask);
+			}
+			first += 16;
+		}
+#endif
+		for (; first != last; ++first)
+		{
+			if (*first != '\n' || last - first < 2)
+			{
+				continue;
+			}
+			// A "\r" with nothing after it is a blank line too, as buffer_line_range drops the '\r'.
+			const bool is_crlf = first[1] == '\r' && (last - first == 2 || first[2] == '\n');
+			if (first[1] == '\n' || is_crlf)
+			{
+				return first;
+			}
+		}
+		return last;
+	}
+
+	// Blocks of lines, split at lines that are blank or equal to a sentinel, which aren't part of any block.
+	// Each block doesn't include the newline after its last line. A sentinel line right at the end doesn't
+	// start another, empty, block, but two sentinel lines in a row have an empty block between them.
+	// Lines are the same as buffer_line_range's, so CRLF files give the same blocks, apart from the '\r's inside them.
+	class buffer_block_iterator
+	{
+	private:
+		const char* m_block = nullptr;	// nullptr at the end.
+		const char* m_block_end = nullptr;
+		const char* m_next_block = nullptr;	// nullptr if this is the last one.
+		const char* m_end = nullptr;
+		std::string_view m_sentinental;
+
+		// The start of the line after the one starting at line, or nullptr if that's the last.
+		const char* after_line(const char* line) const noexcept
+		{
+			const char* const line_end = find_char(line, m_end, '\n');
+			return m_end - line_end <= 1 ? nullptr : line_end + 1;
+		}
+
+		bool is_sentinental_line(const char* line, const char* line_end) const noexcept
+		{
+			if (line != line_end && line_end[-1] == '\r')
+			{
+				--line_end;
+			}
+			return std::string_view{ line, static_cast<std::size_t>(line_end - line) } == m_sentinental;
+		}
+
+		void set_block_end(const char* block_end, const char* next_block) noexcept
+		{
+			if (block_end != m_block && block_end[-1] == '\r')
+			{
+				--block_end;
+			}
+			m_block_end = block_end;
+			m_next_block = next_block;
+		}
+
+		void find_blank_line_block_end() noexcept
+		{
+			if (is_sentinental_line(m_block, find_char(m_block, m_end, '\n')))
+			{
+				set_block_end(m_block, after_line(m_block));
+				return;
+			}
+			const char* const separator = find_blank_line(m_block, m_end);
+			if (separator != m_end)
+			{
+				set_block_end(separator, after_line(separator + 1));
+				return;
+			}
+			set_block_end(m_end[-1] == '\n' ? m_end - 1 : m_end, nullptr);
+		}
+
+		void find_block_end() noexcept
+		{
+			if (m_sentinental.empty())
+			{
+				find_blank_line_block_end();
+				return;
+			}
+			for (const char* line = m_block; ; )
+			{
+				const char* const line_end = find_char(line, m_end, '\n');
+				if (is_sentinental_line(line, line_end))
+				{
+					set_block_end(line == m_block ? m_block : line - 1, after_line(line));
+					return;
+				}
+				if (m_end - line_end <= 1)
+				{
+					set_block_end(line_end, nullptr);
+					return;
+				}
+				line = line_end + 1;
+			}
+		}
+	public:
+		using pointer = const std::string_view*;
+		using reference = std::string_view;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+		explicit buffer_block_iterator(std::string_view buffer, std::string_view sentinental = "") noexcept
+			: m_end{ buffer.data() + buffer.size() }, m_sentinental{ sentinental }
+		{
+			if (!buffer.empty())
+			{
+				m_block = buffer.data();
+				find_block_end();
+			}
+		}
+		buffer_block_iterator() noexcept = default;
+		buffer_block_iterator(const buffer_block_iterator&) noexcept = default;
+		buffer_block_iterator& operator=(const buffer_block_iterator&) noexcept = default;
+
+		bool operator==(const buffer_block_iterator& other) const noexcept
+		{
+			return m_block == other.m_block;
+		}
+
+		bool operator!=(const buffer_block_iterator& other) const noexcept
+		{
+			return !(this->operator==(other));
+		}
+
+		std::string_view operator*() const noexcept
+		{
+			return std::string_view{ m_block, static_cast<std::size_t>(m_block_end - m_block) };
+		}
+
+		buffer_block_iterator& operator++() noexcept
+		{
+			m_block = m_next_block;
+			if (m_block != nullptr)
+			{
+				find_block_end();
+			}
+			return *this;
+		}
+		buffer_block_iterator operator++(int) noexcept
+		{
+			buffer_block_iterator result = *this;
+			++(*this);
+			return result;
+		}
+	};
+
+	class buffer_block_range
+	{
+		std::string_view m_buffer;
+		std::string_view m_sentinental;
+	public:
+		explicit buffer_block_range(std::string_view buffer, std::string_view sentinental = "") noexcept : m_buffer{ buffer }, m_sentinental{ sentinental } {}
+		buffer_block_range(const buffer_block_range& other) noexcept = default;
+		buffer_block_range() = delete;
+		buffer_block_iterator begin() const noexcept { return buffer_block_iterator{ m_buffer, m_sentinental }; }
+		buffer_block_iterator end() const noexcept { return buffer_block_iterator{}; }
+	};
+}
+
+inline utils::buffer_block_iterator begin(utils::buffer_block_range br) noexcept { return br.begin(); }
+inline utils::buffer_block_iterator end(utils::buffer_block_range br) noexcept { return br.end(); }
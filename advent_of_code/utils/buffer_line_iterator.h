@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string_view>
+#include <iterator>
+#include <cstddef>
+#include <cstring>
+#include <bit>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Splits a buffer that's already in memory (e.g. advent::map_puzzle_input(day).view()) into lines
+// without copying: each line is a string_view into the buffer. A use for istream_line_range
+// when the whole input is available.
+namespace utils
+{
+	// Like memchr: the first c in [first,last), or last if there isn't one.
+	// Compares 32 bytes at a time with AVX2, or 16 with SSE2.
+	inline const char* find_char(const char* first, const char* last, char c) noexcept
+	{
+#if defined(__AVX2__)
+		const __m256i target = _mm256_set1_epi8(c);
+		while (last - first >= 32)
+		{
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+			const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)));
+			if (mask != 0)
+			{
+				return first + std::countr_zero(mask);
+			}
+			first += 32;
+		}
+#endif
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+		const __m128i target16 = _mm_set1_epi8(c);
+		while (last - first >= 16)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target16)));
+			if (mask != 0)
+			{
+				return first + std::countr_zero(mask);
+			}
+			first += 16;
+		}
+		while (first != last && *first != c)
+		{
+			++first;
+		}
+		return first;
+#else
+		const void* found = first != last ? std::memchr(first, c, static_cast<std::size_t>(last - first)) : nullptr;
+		return found != nullptr ? static_cast<const char*>(found) : last;
+#endif
+	}
+
+	// Lines of a buffer as string_views. A separator at the very end doesn't start another, empty, line,
+	// and when splitting on '\n' a '\r' before it is dropped, so CRLF files give the same lines.
+	class buffer_line_iterator
+	{
+	private:
+		const char* m_line = nullptr;	// nullptr at the end.
+		const char* m_line_end = nullptr;
+		const char* m_end = nullptr;
+		char m_separator = '\n';
+		void find_line_end() noexcept
+		{
+			m_line_end = find_char(m_line, m_end, m_separator);
+		}
+	public:
+		using pointer = const std::string_view*;
+		using reference = std::string_view;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+		explicit buffer_line_iterator(std::string_view buffer, char separator = '\n') noexcept
+			: m_end{ buffer.data() + buffer.size() }, m_separator{ separator }
+		{
+			if (!buffer.empty())
+			{
+				m_line = buffer.data();
+				find_line_end();
+			}
+		}
+		buffer_line_iterator() noexcept = default;
+		buffer_line_iterator(const buffer_line_iterator&) noexcept = default;
+		buffer_line_iterator& operator=(const buffer_line_iterator&) noexcept = default;
+
+		bool operator==(const buffer_line_iterator& other) const noexcept
+		{
+			return m_line == other.m_line;
+		}
+
+		bool operator!=(const buffer_line_iterator& other) const noexcept
+		{
+			return !(this->operator==(other));
+		}
+
+		std::string_view operator*() const noexcept
+		{
+			std::size_t size = static_cast<std::size_t>(m_line_end - m_line);
+			if (m_separator == '\n' && size > 0 && m_line[size - 1] == '\r')
+			{
+				--size;
+			}
+			return std::string_view{ m_line, size };
+		}
+
+		buffer_line_iterator& operator++() noexcept
+		{
+			if (m_end - m_line_end <= 1)
+			{
+				m_line = nullptr;
+				m_line_end = nullptr;
+			}
+			else
+			{
+				m_line = m_line_end + 1;
+				find_line_end();
+			}
+			return *this;
+		}
+		buffer_line_iterator operator++(int) noexcept
+		{
+			buffer_line_iterator result = *this;
+			++(*this);
+			return result;
+		}
+	};
+
+	class buffer_line_range
+	{
+		std::string_view m_buffer;
+		char m_separator;
+	public:
+		explicit buffer_line_range(std::string_view buffer, char separator = '\n') noexcept : m_buffer{ buffer }, m_separator{ separator } {}
+		buffer_line_range(const buffer_line_range& other) noexcept = default;
+		buffer_line_range() = delete;
+		buffer_line_iterator begin() const noexcept { return buffer_line_iterator{ m_buffer, m_separator }; }
+		buffer_line_iterator end() const noexcept { return buffer_line_iterator{}; }
+	};
+}
+
+inline utils::buffer_line_iterator begin(utils::buffer_line_range lr) noexcept { return lr.begin(); }
+inline utils::buffer_line_iterator end(utils::buffer_line_range lr) noexcept { return lr.end(); }
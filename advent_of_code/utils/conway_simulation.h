@@ -10,6 +10,7 @@
 #include <mutex>
 
 #include "advent/advent_assert.h"
+#include "advent/advent_profile.h"
 #include "sorted_vector.h"
 #include "range_contains.h"
 #include "erase_remove_if.h"
@@ -188,6 +189,8 @@ namespace utils::conway_simulation
 	template<typename CoordType, typename UpdateCellFunc, typename GatherNeighboursFunc>
 	inline void conway_simulation::state<CoordType, UpdateCellFunc, GatherNeighboursFunc>::tick()
 	{
+		AdventProfileScope("conway_simulation::tick");
+
 		// Clear the cached containers.
 		m_next_cells.clear();
 		m_relevant_cells.clear();
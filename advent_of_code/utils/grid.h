@@ -7,7 +7,9 @@
 #include <concepts>
 
 #include "advent/advent_assert.h"
+#include "advent/advent_profile.h"
 #include "istream_line_iterator.h"
+#include "buffer_line_iterator.h"
 #include "coords.h"
 #include "coords_iterators.h"
 #include "int_range.h"
@@ -133,7 +135,18 @@ namespace utils
 
 		void build_from_stream(std::istream& iss, const auto& char_to_node_fn)
 		{
-			for (auto line : utils::istream_line_range{ iss })
+			build_from_lines(utils::istream_line_range{ iss }, char_to_node_fn);
+		}
+
+		void build_from_buffer(std::string_view buffer, const auto& char_to_node_fn)
+		{
+			build_from_lines(utils::buffer_line_range{ buffer }, char_to_node_fn);
+		}
+
+		// Any range of string_views, one per row.
+		void build_from_lines(const auto& lines, const auto& char_to_node_fn)
+		{
+			for (std::string_view line : lines)
 			{
 				if(m_max_point.x == 0)
 				{
@@ -199,6 +212,14 @@ namespace utils
 			return result;
 		}
 
+		auto build(std::string_view buffer, const auto& char_to_node_fn)
+		{
+			using NodeType = decltype(char_to_node_fn(' '));
+			grid<NodeType> result;
+			result.build_from_buffer(buffer, char_to_node_fn);
+			return result;
+		}
+
 		template <typename NodeType>
 		struct DefaultHeuristicFunctor
 		{
@@ -486,6 +507,7 @@ inline std::size_t utils::grid<NodeType>::get_idx(std::integral auto x, std::int
 template<typename NodeType>
 inline utils::small_vector<utils::coords,1> utils::grid<NodeType>::get_path(const utils::coords& start, const auto& is_end_fn, const auto& traverse_cost_fn, const auto& heuristic_fn) const
 {
+	AdventProfileScope("grid::get_path");
 	AdventCheck(is_on_grid(start));
 	constexpr bool check_end_fn = utils::grid_helpers::is_end_fn<NodeType,decltype(is_end_fn)>();
 	constexpr bool check_traverse_fn = utils::grid_helpers::is_cost_fn<NodeType,decltype(traverse_cost_fn)>();
@@ -654,7 +676,7 @@ inline utils::small_vector<utils::coords,1> utils::grid<NodeType>::get_path(cons
 	}
 	if constexpr (is_heuristic_fn)
 	{
-		auto cost_fn = utils::grid_helpers::DefaultCostFunctor<false>{};
+		auto cost_fn = utils::grid_helpers::DefaultCostFunctor<NodeType,false>{};
 		return get_path(start, is_end_fn, cost_fn, cost_or_heuristic_fn);
 	}
 	AdventUnreachable();
@@ -664,7 +686,7 @@ inline utils::small_vector<utils::coords,1> utils::grid<NodeType>::get_path(cons
 template<typename NodeType>
 inline utils::small_vector<utils::coords,1> utils::grid<NodeType>::get_path(const utils::coords& start, const auto& is_end_fn) const
 {
-	return get_path(start, is_end_fn, utils::grid_helpers::DefaultCostFunctor<false>{}, utils::grid_helpers::DefaultHeuristicFunctor<NodeType>{});
+	return get_path(start, is_end_fn, utils::grid_helpers::DefaultCostFunctor<NodeType,false>{}, utils::grid_helpers::DefaultHeuristicFunctor<NodeType>{});
 }
 
 template<typename NodeType>
@@ -690,7 +712,7 @@ inline utils::small_vector<utils::coords,1> utils::grid<NodeType>::get_path(cons
 	}
 	if constexpr (is_heuristic_fn)
 	{
-		auto cost_fn = utils::grid_helpers::DefaultCostFunctor<false>{};
+		auto cost_fn = utils::grid_helpers::DefaultCostFunctor<NodeType,false>{};
 		return get_path(start, end, cost_fn, cost_or_heuristic_fn);
 	}
 	AdventUnreachable();
@@ -700,7 +722,7 @@ inline utils::small_vector<utils::coords,1> utils::grid<NodeType>::get_path(cons
 template<typename NodeType>
 inline utils::small_vector<utils::coords,1> utils::grid<NodeType>::get_path(const utils::coords& start, const utils::coords& end) const
 {
-	return get_path(start, end, utils::grid_helpers::DefaultCostFunctor{}, utils::grid_helpers::DefaultHeuristicFunctor<NodeType>{ end });
+	return get_path(start, end, utils::grid_helpers::DefaultCostFunctor<NodeType,false>{}, utils::grid_helpers::DefaultHeuristicFunctor<NodeType>{ end });
 }
 
 template<typename NodeType>
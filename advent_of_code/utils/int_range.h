@@ -90,7 +90,7 @@ namespace utils
 		using difference_type = std::ptrdiff_t;
 
 		const AdaptorFn& get_adapter() const noexcept { return adaptor_fn; }
-		const int_range<std::size_t>& get_underlying_range() const noexcept { return range; }
+		const int_range<std::ptrdiff_t>& get_underlying_range() const noexcept { return range; }
 
 		// Constructors
 		constexpr int_range_adaptor(AdaptorFn fn, std::ptrdiff_t start, std::ptrdiff_t finish, std::ptrdiff_t stride_length) noexcept :
@@ -4,96 +4,120 @@
 #include <string>
 #include <string_view>
 #include <iterator>
-#include <sstream>
-#include <stdexcept>
 #include <optional>
 
 namespace utils
 {
-
+	// Reads one block at a time, so the stream is left just after the block's separator and can be
+	// used for something else afterwards. Blocks are the same as buffer_block_range's. When the whole
+	// input is in memory anyway, buffer_block_range over advent::map_puzzle_input(day).view() avoids copying it.
 	class istream_block_iterator
 	{
 	private:
-		std::istream* m_stream;
+		mutable std::istream* m_stream;	// nullptr once there are no more blocks to read.
 		std::string_view m_sentinental;
-		bool is_at_end() const { return m_stream == nullptr; }
-		std::optional<std::string> m_cached_result;
-		void read_next_block()
+		mutable std::optional<std::string> m_block;
+		mutable std::string m_line;
+
+		bool is_sentinental_line() const noexcept
 		{
-			if (is_at_end())
+			std::string_view line = m_line;
+			if (!line.empty() && line.back() == '\r')
 			{
-				throw std::range_error{ "Cannot deference an at-the-end stream block iterator" };
+				line.remove_suffix(1);
 			}
+			return line == m_sentinental;
+		}
 
-			std::ostringstream result_stream;
-			std::string line;
-			while (true)
+		void finish_block() const
+		{
+			std::string& block = *m_block;
+			if (!block.empty())
 			{
-				std::getline(*m_stream, line);
-				if (line == m_sentinental)
-				{
-					break;
-				}
-				result_stream << line << '\n';
-				if (m_stream->eof())
+				block.pop_back();
+			}
+			if (!block.empty() && block.back() == '\r')
+			{
+				block.pop_back();
+			}
+		}
+
+		void read_next_block() const
+		{
+			bool any_lines = false;
+			m_block.emplace();
+			while (std::getline(*m_stream, m_line))
+			{
+				any_lines = true;
+				if (is_sentinental_line())
 				{
-					m_stream = nullptr;
-					break;
+					finish_block();
+					return;
 				}
+				m_block->append(m_line);
+				m_block->push_back('\n');
 			}
-
-			// Get the result and remove the trailing '\n'.
-			std::string result = result_stream.str();
-			if (!result.empty())
+			m_stream = nullptr;
+			if (any_lines)
+			{
+				finish_block();
+			}
+			else
 			{
-				AdventCheck(result.back() == '\n');
-				result.pop_back();
+				m_block.reset();
 			}
-			m_cached_result = std::move(result);
 		}
-		void maybe_read_next_block()
+
+		void maybe_read_next_block() const
 		{
-			if (!m_cached_result.has_value())
+			if (!m_block.has_value() && m_stream != nullptr)
 			{
 				read_next_block();
 			}
 		}
+
+		bool is_at_end() const
+		{
+			maybe_read_next_block();
+			return !m_block.has_value();
+		}
 	public:
-		using pointer = const std::string*;
-		using reference = const std::string&;
-		using value_type = std::string;
-		using difference_type = int;
+		using pointer = const std::string_view*;
+		using reference = std::string_view;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
 		using iterator_category = std::input_iterator_tag;
 		explicit istream_block_iterator(std::istream& stream, std::string_view sentinental = "") noexcept
 			: m_stream{ &stream }, m_sentinental{ sentinental }{}
 		istream_block_iterator() noexcept : m_stream{ nullptr }, m_sentinental{}{}
-		istream_block_iterator(const istream_block_iterator&) noexcept = default;
-		istream_block_iterator& operator=(const istream_block_iterator&) noexcept = default;
+		istream_block_iterator(const istream_block_iterator&) = default;
+		istream_block_iterator& operator=(const istream_block_iterator&) = default;
 
-		bool operator==(const istream_block_iterator& other) const noexcept
+		bool operator==(const istream_block_iterator& other) const
 		{
 			return is_at_end() && other.is_at_end();
 		}
 
-		bool operator!=(const istream_block_iterator& other) const noexcept
+		bool operator!=(const istream_block_iterator& other) const
 		{
 			return !(this->operator==(other));
 		}
 
-		std::string_view operator*()
+		std::string_view operator*() const
 		{
 			maybe_read_next_block();
-			return m_cached_result.value();
+			return m_block.value();
 		}
 
-		istream_block_iterator& operator++() noexcept
+		istream_block_iterator& operator++()
 		{
 			maybe_read_next_block();
-			m_cached_result.reset();
+			m_block.reset();
 			return *this;
 		}
-		istream_block_iterator  operator++(int) noexcept
-		{	
+		istream_block_iterator  operator++(int)
+		{
+			maybe_read_next_block();
 			istream_block_iterator result = *this;
 			++(*this);
 			return result;
@@ -103,14 +127,15 @@ namespace utils
 	class istream_block_range
 	{
 		std::istream& stream;
+		std::string_view m_sentinental;
 	public:
-		explicit istream_block_range(std::istream& input) : stream{ input } {}
+		explicit istream_block_range(std::istream& input, std::string_view sentinental = "") : stream{ input }, m_sentinental{ sentinental } {}
 		istream_block_range(const istream_block_range& other) = default;
 		istream_block_range() = delete;
-		istream_block_iterator begin() const { return istream_block_iterator{ stream }; }
+		istream_block_iterator begin() const { return istream_block_iterator{ stream, m_sentinental }; }
 		istream_block_iterator end() const { return istream_block_iterator{}; }
 	};
 }
 
 inline utils::istream_block_iterator begin(utils::istream_block_range lr) { return lr.begin(); }
-inline utils::istream_block_iterator end(utils::istream_block_range lr) { return lr.end(); }
\ No newline at end of file
+inline utils::istream_block_iterator end(utils::istream_block_range lr) { return lr.end(); }
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "buffer_line_iterator.h"
+
+#include "advent/advent_assert.h"
+
+namespace utils
+{
+	// Where every line of a buffer starts, found in one pass with find_char. Gives random access to lines,
+	// and splits the buffer into chunks on line boundaries so they can be parsed on separate threads.
+	// Lines are the same as buffer_line_range's. The buffer must outlive the index and be under 4GB.
+	class line_index
+	{
+	public:
+		// A run of whole lines: [first_line, last_line) and the text they cover,
+		// which can be split again with buffer_line_range.
+		struct chunk
+		{
+			std::size_t first_line = 0;
+			std::size_t last_line = 0;
+			std::string_view text;
+			std::size_t num_lines() const noexcept { return last_line - first_line; }
+		};
+	private:
+		std::string_view m_buffer;
+		char m_separator;
+
+		// One per line, then one more: where a line would start after the last one.
+		// So line i is [m_starts[i], m_starts[i+1] - 1), less a '\r' at the end.
+		std::vector<uint32_t> m_starts;
+
+		std::size_t line_end(std::size_t i) const noexcept { return m_starts[i + 1] - 1; }
+	public:
+		explicit line_index(std::string_view buffer, char separator = '\n')
+			: m_buffer{ buffer }, m_separator{ separator }
+		{
+			AdventCheckMsg(buffer.size() < std::numeric_limits<uint32_t>::max(), "Buffer too large for a line_index");
+			if (buffer.empty())
+			{
+				m_starts.push_back(0);
+				return;
+			}
+			const char* const first = buffer.data();
+			const char* const last = first + buffer.size();
+			const char* line = first;
+			while (line != last)
+			{
+				m_starts.push_back(static_cast<uint32_t>(line - first));
+				const char* const separator_pos = find_char(line, last, separator);
+				if (separator_pos == last)
+				{
+					// No separator after the last line, but pretend there is one.
+					m_starts.push_back(static_cast<uint32_t>(buffer.size() + 1));
+					return;
+				}
+				line = separator_pos + 1;
+			}
+			m_starts.push_back(static_cast<uint32_t>(buffer.size()));
+		}
+
+		std::size_t size() const noexcept { return m_starts.size() - 1; }
+		bool empty() const noexcept { return size() == 0; }
+		std::string_view buffer() const noexcept { return m_buffer; }
+
+		// Offset of the start of line i in the buffer.
+		std::size_t line_start(std::size_t i) const
+		{
+			AdventCheck(i < size());
+			return m_starts[i];
+		}
+
+		std::string_view line(std::size_t i) const
+		{
+			AdventCheck(i < size());
+			std::string_view result = m_buffer.substr(m_starts[i], line_end(i) - m_starts[i]);
+			if (m_separator == '\n' && !result.empty() && result.back() == '\r')
+			{
+				result.remove_suffix(1);
+			}
+			return result;
+		}
+
+		std::string_view operator[](std::size_t i) const { return line(i); }
+
+		// The text of lines [first_line, last_line), including the separator after the last of them
+		// if there is one, for passing to buffer_line_range.
+		std::string_view text(std::size_t first_line, std::size_t last_line) const
+		{
+			AdventCheck(first_line <= last_line);
+			AdventCheck(last_line <= size());
+			const std::size_t start = m_starts[first_line];
+			const std::size_t end = std::min<std::size_t>(m_starts[last_line], m_buffer.size());
+			return m_buffer.substr(start, end - start);
+		}
+
+		// At most num_chunks chunks covering every line in order, with about the same number of bytes in each.
+		// Fewer if there aren't enough lines, and none are empty.
+		std::vector<chunk> split(std::size_t num_chunks) const
+		{
+			AdventCheck(num_chunks > 0);
+			std::vector<chunk> result;
+			result.reserve(std::min(num_chunks, size()));
+			std::size_t first_line = 0;
+			for (std::size_t c = 1; c <= num_chunks && first_line < size(); ++c)
+			{
+				// The first line starting at or after this chunk's share of the buffer.
+				const uint64_t target = static_cast<uint64_t>(m_buffer.size()) * c / num_chunks;
+				const auto found = std::lower_bound(begin(m_starts) + static_cast<std::ptrdiff_t>(first_line) + 1, end(m_starts) - 1, target);
+				const std::size_t last_line = c == num_chunks ? size() : static_cast<std::size_t>(found - begin(m_starts));
+				if (last_line > first_line)
+				{
+					result.push_back(chunk{ first_line, last_line, text(first_line, last_line) });
+					first_line = last_line;
+				}
+			}
+			return result;
+		}
+	};
+}
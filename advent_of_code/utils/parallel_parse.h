@@ -0,0 +1,151 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <thread>
+
+#include "buffer_line_iterator.h"
+#include "work_stealing_pool.h"
+
+#include "advent/advent_assert.h"
+
+// Parse-and-reduce over the lines of a buffer on several threads, e.g. summing a number from every line
+// of advent::map_puzzle_input(day).view():
+//
+//     const int64_t total = utils::parallel_parse(input.view(), [](std::string_view line)
+//         {
+//             return utils::to_value<int64_t>(line);
+//         }, std::plus<>{});
+namespace utils
+{
+	// Cuts the buffer into at most num_chunks pieces of about the same size, each ending just after a separator
+	// (or at the end of the buffer). Splitting every piece with buffer_line_range gives the same lines as the whole.
+	inline std::vector<std::string_view> split_at_lines(std::string_view buffer, std::size_t num_chunks, char separator = '\n')
+	{
+		AdventCheck(num_chunks > 0);
+		std::vector<std::string_view> result;
+		result.reserve(num_chunks);
+		const char* const first = buffer.data();
+		const char* const last = first + buffer.size();
+		const char* chunk_start = first;
+		for (std::size_t c = 1; c <= num_chunks && chunk_start != last; ++c)
+		{
+			const char* chunk_end = last;
+			if (c != num_chunks)
+			{
+				const char* const target = std::max(chunk_start, first + buffer.size() * c / num_chunks);
+				chunk_end = find_char(target, last, separator);
+				if (chunk_end != last)
+				{
+					++chunk_end;
+				}
+			}
+			result.emplace_back(chunk_start, static_cast<std::size_t>(chunk_end - chunk_start));
+			chunk_start = chunk_end;
+		}
+		return result;
+	}
+
+	namespace parallel_parse_internal
+	{
+		// Below this there's not enough work to be worth handing to other threads.
+		constexpr std::size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+		// More chunks than workers, so a worker that finishes early can steal from a slower one.
+		constexpr std::size_t CHUNKS_PER_WORKER = 4;
+
+		template <typename LineFn>
+		using line_result_t = std::decay_t<std::invoke_result_t<const LineFn&, std::string_view>>;
+
+		template <typename LineFn, typename CombineFn>
+		std::optional<line_result_t<LineFn>> parse_lines(std::string_view text, const LineFn& per_line_fn, const CombineFn& combine_fn)
+		{
+			std::optional<line_result_t<LineFn>> result;
+			for (std::string_view line : buffer_line_range{ text })
+			{
+				if (result.has_value())
+				{
+					*result = combine_fn(std::move(*result), per_line_fn(line));
+				}
+				else
+				{
+					result.emplace(per_line_fn(line));
+				}
+			}
+			return result;
+		}
+
+		template <typename LineFn, typename CombineFn>
+		auto combine_in_order(std::vector<std::optional<line_result_t<LineFn>>>& partials, const CombineFn& combine_fn)
+		{
+			std::optional<line_result_t<LineFn>> result;
+			for (auto& partial : partials)
+			{
+				if (!partial.has_value())
+				{
+					continue;
+				}
+				if (result.has_value())
+				{
+					*result = combine_fn(std::move(*result), std::move(*partial));
+				}
+				else
+				{
+					result = std::move(partial);
+				}
+			}
+			return result.has_value() ? std::move(*result) : line_result_t<LineFn>{};
+		}
+	}
+
+	// Calls per_line_fn on every line of the buffer and folds the results together with combine_fn,
+	// as combine_fn(combine_fn(line0, line1), line2) and so on. Each chunk of lines is folded on one of
+	// the pool's workers, then the chunks' results are combined in input order on the calling thread,
+	// so combine_fn needs to be associative but needn't be commutative, and the result doesn't depend on timing.
+	// Both functions are called from several threads at once. Returns a value-initialized result if there are no lines.
+	template <typename LineFn, typename CombineFn>
+	auto parallel_parse(work_stealing_pool& pool, std::string_view buffer, const LineFn& per_line_fn, const CombineFn& combine_fn)
+	{
+		using namespace parallel_parse_internal;
+		const std::size_t max_chunks = std::max(buffer.size() / MIN_CHUNK_SIZE, std::size_t{ 1 });
+		const std::vector<std::string_view> chunks = split_at_lines(buffer, std::min(pool.size() * CHUNKS_PER_WORKER, max_chunks));
+
+		std::vector<std::optional<line_result_t<LineFn>>> partials(chunks.size());
+		if (chunks.size() == 1)
+		{
+			partials.front() = parse_lines(chunks.front(), per_line_fn, combine_fn);
+		}
+		else
+		{
+			for (std::size_t i = 0; i < chunks.size(); ++i)
+			{
+				pool.push([&partials, &chunks, &per_line_fn, &combine_fn, i](std::size_t)
+					{
+						partials[i] = parse_lines(chunks[i], per_line_fn, combine_fn);
+					});
+			}
+			pool.wait();
+		}
+		return combine_in_order<LineFn>(partials, combine_fn);
+	}
+
+	// As above, with a pool of one worker per hardware thread, made only if the buffer is big enough to need it.
+	template <typename LineFn, typename CombineFn>
+	auto parallel_parse(std::string_view buffer, const LineFn& per_line_fn, const CombineFn& combine_fn)
+	{
+		using namespace parallel_parse_internal;
+		// Asking is a system call, so only do it once.
+		static const std::size_t num_workers = std::max(std::thread::hardware_concurrency(), 1u);
+		if (buffer.size() < 2 * MIN_CHUNK_SIZE || num_workers == 1)
+		{
+			std::optional<line_result_t<LineFn>> result = parse_lines(buffer, per_line_fn, combine_fn);
+			return result.has_value() ? std::move(*result) : line_result_t<LineFn>{};
+		}
+		work_stealing_pool pool{ num_workers };
+		return parallel_parse(pool, buffer, per_line_fn, combine_fn);
+	}
+}
@@ -736,7 +736,7 @@ inline constexpr typename utils::small_vector<T, STACK_SIZE, ALLOC>::iterator ut
 	//AdventCheck(gap.initialized_memory.size() != gap.uninitialised_memory.size());
 	move_buffer_to_memory(Buffer{ &value,(&value) + 1 }, gap);
 	++m_num_elements;
-	return gap.initialised_memory.empty() ? gap.uninitialised_memory.finish : gap.initialised_memory.finish;
+	return gap.get_unified_buffer().start;
 }
 
 template<typename T, std::size_t STACK_SIZE, typename ALLOC>
@@ -745,7 +745,7 @@ inline constexpr typename utils::small_vector<T, STACK_SIZE, ALLOC>::iterator ut
 	const GapDescription gap = make_gap_for_insert(pos, count);
 	fill_memory(gap, value);
 	m_num_elements += count;
-	return gap.initialised_memory.empty() ? gap.uninitialised_memory.finish : gap.initialised_memory.finish;
+	return gap.get_unified_buffer().start;
 }
 
 template<typename T, std::size_t STACK_SIZE, typename ALLOC>
@@ -795,14 +795,15 @@ inline constexpr typename utils::small_vector<T, STACK_SIZE, ALLOC>::iterator ut
 			uninit = new(uninit) T(*(it++));
 		}
 		m_num_elements += size_increase;
-		return gap.get_unified_buffer().finish;
+		return gap.get_unified_buffer().start;
 	}
 	// Can't use std::difference
+	const auto first_idx = pos - cbegin();
 	for (auto it = first; it != last; ++it)
 	{
-		pos = insert(pos, *it);
+		pos = insert(pos, *it) + 1;
 	}
-	return pos;
+	return begin() + first_idx;
 }
 
 template<typename T, std::size_t STACK_SIZE, typename ALLOC>
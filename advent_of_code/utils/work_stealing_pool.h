@@ -0,0 +1,191 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <algorithm>
+#include <utility>
+
+#include "advent/advent_assert.h"
+
+namespace utils
+{
+	// A fixed-size pool of threads where each worker owns a queue of jobs.
+	// Workers take jobs from the front of their own queue, and when that runs dry they steal
+	// from the back of another worker's queue. Jobs are told which worker is running them.
+	class work_stealing_pool
+	{
+	public:
+		using job = std::function<void(std::size_t worker_idx)>;
+	private:
+		struct worker_queue
+		{
+			std::mutex lock;
+			std::deque<job> jobs;
+		};
+
+		std::vector<std::unique_ptr<worker_queue>> m_queues;
+		std::vector<std::thread> m_threads;
+		std::mutex m_state_lock;
+		std::condition_variable m_work_available;
+		std::condition_variable m_all_done;
+		std::size_t m_num_queued = 0;
+		std::size_t m_num_unfinished = 0;
+		std::size_t m_next_queue = 0;
+		bool m_stopping = false;
+		std::exception_ptr m_first_error;
+
+		bool try_pop_front(std::size_t queue_idx, job& out)
+		{
+			worker_queue& queue = *m_queues[queue_idx];
+			std::scoped_lock guard{ queue.lock };
+			if (queue.jobs.empty()) return false;
+			out = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			return true;
+		}
+
+		bool try_steal_back(std::size_t queue_idx, job& out)
+		{
+			worker_queue& queue = *m_queues[queue_idx];
+			std::scoped_lock guard{ queue.lock };
+			if (queue.jobs.empty()) return false;
+			out = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			return true;
+		}
+
+		bool try_get_job(std::size_t worker_idx, job& out)
+		{
+			if (try_pop_front(worker_idx, out)) return true;
+			for (std::size_t offset = 1; offset < m_queues.size(); ++offset)
+			{
+				if (try_steal_back((worker_idx + offset) % m_queues.size(), out)) return true;
+			}
+			return false;
+		}
+
+		void worker_loop(std::size_t worker_idx)
+		{
+			while (true)
+			{
+				{
+					std::unique_lock guard{ m_state_lock };
+					m_work_available.wait(guard, [this]() { return m_stopping || m_num_queued > 0; });
+					if (m_num_queued == 0)
+					{
+						AdventCheck(m_stopping);
+						return;
+					}
+					--m_num_queued;
+				}
+
+				// Someone has to have the job we just reserved, so keep looking until we find it.
+				job next_job;
+				while (!try_get_job(worker_idx, next_job))
+				{
+					std::this_thread::yield();
+				}
+
+				try
+				{
+					next_job(worker_idx);
+				}
+				catch (...)
+				{
+					std::scoped_lock guard{ m_state_lock };
+					if (!m_first_error)
+					{
+						m_first_error = std::current_exception();
+					}
+				}
+
+				std::scoped_lock guard{ m_state_lock };
+				--m_num_unfinished;
+				if (m_num_unfinished == 0)
+				{
+					m_all_done.notify_all();
+				}
+			}
+		}
+	public:
+		explicit work_stealing_pool(std::size_t num_workers)
+		{
+			num_workers = std::max(num_workers, std::size_t{ 1 });
+			m_queues.reserve(num_workers);
+			for (std::size_t i = 0; i < num_workers; ++i)
+			{
+				m_queues.push_back(std::make_unique<worker_queue>());
+			}
+			m_threads.reserve(num_workers);
+			for (std::size_t i = 0; i < num_workers; ++i)
+			{
+				m_threads.emplace_back([this, i]() { worker_loop(i); });
+			}
+		}
+
+		work_stealing_pool(const work_stealing_pool&) = delete;
+		work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+		~work_stealing_pool()
+		{
+			{
+				std::scoped_lock guard{ m_state_lock };
+				m_stopping = true;
+			}
+			m_work_available.notify_all();
+			for (std::thread& t : m_threads)
+			{
+				t.join();
+			}
+		}
+
+		std::size_t size() const noexcept { return m_threads.size(); }
+
+		// Queue a job on a specific worker. Other workers may still steal it.
+		void push(job new_job, std::size_t worker_idx)
+		{
+			AdventCheck(worker_idx < m_queues.size());
+			{
+				worker_queue& queue = *m_queues[worker_idx];
+				std::scoped_lock guard{ queue.lock };
+				queue.jobs.push_back(std::move(new_job));
+			}
+			{
+				std::scoped_lock guard{ m_state_lock };
+				++m_num_queued;
+				++m_num_unfinished;
+			}
+			m_work_available.notify_one();
+		}
+
+		// Queue a job, spreading jobs across the workers round-robin.
+		void push(job new_job)
+		{
+			std::size_t worker_idx = 0;
+			{
+				std::scoped_lock guard{ m_state_lock };
+				worker_idx = m_next_queue;
+				m_next_queue = (m_next_queue + 1) % m_queues.size();
+			}
+			push(std::move(new_job), worker_idx);
+		}
+
+		// Blocks until every queued job has finished. If any job threw, the first exception is rethrown here.
+		void wait()
+		{
+			std::unique_lock guard{ m_state_lock };
+			m_all_done.wait(guard, [this]() { return m_num_unfinished == 0; });
+			if (m_first_error)
+			{
+				std::exception_ptr error = std::exchange(m_first_error, nullptr);
+				std::rethrow_exception(error);
+			}
+		}
+	};
+}